@@ -0,0 +1,11 @@
+/* config.h
+ *
+ * Keymap level configuration for QMK, included ahead of every source file.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+// Room for four 64 byte settings slots, see settings.h
+#define EECONFIG_USER_DATA_SIZE 256
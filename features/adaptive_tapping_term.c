@@ -0,0 +1,193 @@
+/* adaptive_tapping_term.c
+ *
+ * Learns a tapping term for each tap dance key from how long the key is actually pressed. Every press of a TD() key
+ * is timed, and on release the duration is added to a small histogram of taps or of holds. Once a key has enough
+ * taps its term is moved to the shortest threshold that keeps misfires within ADAPTIVE_TERM_MISFIRE of the best
+ * possible threshold, so each key holds as early as its own usage allows.
+ *
+ * Presses are sorted against the configured term rather than by how the dance resolved them. A tap that outlasts a
+ * learned term is still resolved as a hold, and learning from that would shorten the term further each time it
+ * happened. Only single presses are learned from. Double taps and holds that were resolved early by another key
+ * (PERMISSIVE_HOLD) do not say anything about the term. Histograms are halved when a bucket fills up so recent
+ * presses outweigh old ones.
+ *
+ * The learned term only decides whether a first press is a hold. QMK also uses the term as the window for the next
+ * press of a dance, and a short window would make double taps and double holds unreachable, which for a dance such
+ * as one holding a config layer on its double hold would lock the user out. That window always gets the configured
+ * term.
+ *
+ * Requires the following features in rules.mk
+ * TAP_DANCE_ENABLE = yes
+ *
+ * Call process_adaptive_term from process_record_user and adaptive_term_get from get_tapping_term, and define
+ * adaptive_term_changed_user to save the learned terms.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "adaptive_tapping_term.h"
+
+#ifndef ADAPTIVE_TERM_BUCKET
+#define ADAPTIVE_TERM_BUCKET 20 // Width of each histogram bucket in ms
+#endif
+
+#ifndef ADAPTIVE_TERM_MIN
+#define ADAPTIVE_TERM_MIN 80
+#endif
+
+#ifndef ADAPTIVE_TERM_SAMPLES
+#define ADAPTIVE_TERM_SAMPLES 32 // Taps needed before a key's term is learned
+#endif
+
+#ifndef ADAPTIVE_TERM_MISFIRE
+#define ADAPTIVE_TERM_MISFIRE 20 // Extra misfires allowed per 1000 presses in exchange for a shorter term
+#endif
+
+#define ADAPTIVE_TERM_BUCKETS 16
+
+typedef struct {
+	uint8_t  taps[ADAPTIVE_TERM_BUCKETS];
+	uint8_t  holds[ADAPTIVE_TERM_BUCKETS];
+	uint16_t press_time;
+	uint16_t configured; // Term the keymap passed to adaptive_term_get, zero until it has been asked
+	uint16_t term;       // Zero until the key has been learned or loaded
+} adaptive_key_t;
+
+static adaptive_key_t keys[ADAPTIVE_TERM_KEYS];
+
+bool adaptive_term_enabled = true;
+
+static void add_sample(adaptive_key_t *key, uint8_t *histogram, uint16_t duration) {
+	uint8_t bucket = duration / ADAPTIVE_TERM_BUCKET;
+
+	if (bucket >= ADAPTIVE_TERM_BUCKETS) {
+		bucket = ADAPTIVE_TERM_BUCKETS - 1;
+	}
+
+	if (histogram[bucket] == UINT8_MAX) {
+		for (uint8_t i = 0; i < ADAPTIVE_TERM_BUCKETS; i++) {
+			key->taps[i] >>= 1;
+			key->holds[i] >>= 1;
+		}
+	}
+	histogram[bucket]++;
+}
+
+/* A threshold at the end of bucket i misfires on every tap above it and every hold below it. Find the fewest
+ * misfires any threshold can manage, then take the earliest threshold within ADAPTIVE_TERM_MISFIRE of that.
+ */
+static void learn(uint8_t index) {
+	adaptive_key_t *key = &keys[index];
+	uint16_t taps = 0;
+	uint16_t holds = 0;
+
+	for (uint8_t i = 0; i < ADAPTIVE_TERM_BUCKETS; i++) {
+		taps += key->taps[i];
+		holds += key->holds[i];
+	}
+	if (taps < ADAPTIVE_TERM_SAMPLES) {
+		return;
+	}
+
+	uint16_t misfires[ADAPTIVE_TERM_BUCKETS];
+	uint16_t best = UINT16_MAX;
+	uint16_t above = taps;
+	uint16_t below = 0;
+
+	for (uint8_t i = 0; i < ADAPTIVE_TERM_BUCKETS; i++) {
+		above -= key->taps[i];
+		below += key->holds[i];
+		misfires[i] = above + below;
+
+		if (misfires[i] < best) {
+			best = misfires[i];
+		}
+	}
+
+	uint16_t allowed = best + ((uint32_t)(taps + holds) * ADAPTIVE_TERM_MISFIRE / 1000);
+
+	for (uint8_t i = 0; i < ADAPTIVE_TERM_BUCKETS; i++) {
+		if (misfires[i] <= allowed) {
+			uint16_t term = (i + 1) * ADAPTIVE_TERM_BUCKET;
+
+			if (key->term != term) {
+				key->term = term;
+				adaptive_term_changed_user(index);
+			}
+			return;
+		}
+	}
+}
+
+void process_adaptive_term(uint16_t keycode, keyrecord_t *record) {
+	if (!IS_QK_TAP_DANCE(keycode) || (QK_TAP_DANCE_GET_INDEX(keycode) >= ADAPTIVE_TERM_KEYS)) {
+		return;
+	}
+
+	uint8_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+	adaptive_key_t *key = &keys[index];
+
+	if (record->event.pressed) {
+		key->press_time = record->event.time;
+		return;
+	}
+
+	// This runs before process_tap_dance, so the dance still shows how the press that just ended was resolved
+	tap_dance_state_t *state = &tap_dance_actions[index].state;
+
+	if ((state->count != 1) || state->interrupted || !key->configured) {
+		return;
+	}
+
+	uint16_t duration = record->event.time - key->press_time;
+
+	add_sample(key, (duration >= key->configured) ? key->holds : key->taps, duration);
+	learn(index);
+}
+
+// Learned terms are never longer than the configured term, which is the most a tap could have been measured at
+uint16_t adaptive_term_get(uint16_t keycode, uint16_t fallback) {
+	if (!IS_QK_TAP_DANCE(keycode) || (QK_TAP_DANCE_GET_INDEX(keycode) >= ADAPTIVE_TERM_KEYS)) {
+		return fallback;
+	}
+
+	uint8_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+	tap_dance_state_t *state = &tap_dance_actions[index].state;
+	uint16_t term = keys[index].term;
+
+	keys[index].configured = fallback;
+
+	// Once the first press is released the term is the window for the next press, see above
+	if (!adaptive_term_enabled || !term || !state->pressed || (state->count > 1)) {
+		return fallback;
+	}
+	if (term < ADAPTIVE_TERM_MIN) {
+		term = ADAPTIVE_TERM_MIN;
+	}
+	return (term < fallback) ? term : fallback;
+}
+
+uint16_t adaptive_term_learned(uint8_t index) {
+	return (index < ADAPTIVE_TERM_KEYS) ? keys[index].term : 0;
+}
+
+void adaptive_term_set(uint8_t index, uint16_t term) {
+	if (index < ADAPTIVE_TERM_KEYS) {
+		keys[index].term = term;
+	}
+}
+
+uint8_t adaptive_term_count(void) {
+	uint8_t count = 0;
+
+	for (uint8_t i = 0; i < ADAPTIVE_TERM_KEYS; i++) {
+		if (keys[i].term) {
+			count++;
+		}
+	}
+	return count;
+}
+
+void adaptive_term_reset(void) {
+	memset(keys, 0, sizeof(keys));
+}
@@ -0,0 +1,31 @@
+/* adaptive_tapping_term.h
+ *
+ * Header file for learning a tapping term for each tap dance key in keyboard firmware.
+ * Declares the hook for process_record_user, the lookup for get_tapping_term and functions to load, save and reset
+ * the learned terms.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// Number of tap dance keys, starting from TD(0), that have a learned term
+#ifndef ADAPTIVE_TERM_KEYS
+#define ADAPTIVE_TERM_KEYS 16
+#endif
+
+// Learned terms are only used while this is set, learning continues either way
+extern bool adaptive_term_enabled;
+
+void process_adaptive_term(uint16_t keycode, keyrecord_t *record);
+uint16_t adaptive_term_get(uint16_t keycode, uint16_t fallback);
+
+uint16_t adaptive_term_learned(uint8_t index);
+void adaptive_term_set(uint8_t index, uint16_t term);
+uint8_t adaptive_term_count(void);
+void adaptive_term_reset(void);
+
+// Defined by the keymap, called when a key learns a new term so it can be saved
+void adaptive_term_changed_user(uint8_t index);
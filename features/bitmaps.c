@@ -10,10 +10,199 @@
 #include "quantum.h"
 
 // Maybe I should be writing directly to oled_buffer but its not public and I'm not short on memory.
-static char render_buffer[1024];
+// The buffers are stored as words so transitions can blend 32 bits at a time, everything else uses the byte views.
+static uint32_t render_words[1024 / 4];
+static char *const render_buffer = (char *)render_words;
+
+// =========================
+// = Pages and Transitions =
+// =========================
+/* Renderers draw one page at a time into the buffer from page_begin and hand it back with page_end. Normally that is
+ * render_buffer itself, but during a transition the incoming page is drawn into page_buffer and blended into
+ * render_buffer, which still holds the outgoing frame wherever the incoming one has not been let through yet. Each
+ * frame raises the threshold of a Bayer matrix so more pixels are let through, and a pixel that has switched keeps
+ * showing the live incoming frame. The outgoing frame is frozen, as there is nowhere to render it to.
+ */
+static uint32_t page_words[128 / 4];
+static char *const page_buffer = (char *)page_words;
+
+// Ordered dither thresholds from 0 to 63, indexed by [row][column] within each 8x8 block
+static const uint8_t bayer[8][8] = {
+	{  0, 32,  8, 40,  2, 34, 10, 42 },
+	{ 48, 16, 56, 24, 50, 18, 58, 26 },
+	{ 12, 44,  4, 36, 14, 46,  6, 38 },
+	{ 60, 28, 52, 20, 62, 30, 54, 22 },
+	{  3, 35, 11, 43,  1, 33,  9, 41 },
+	{ 51, 19, 59, 27, 49, 17, 57, 25 },
+	{ 15, 47,  7, 39, 13, 45,  5, 37 },
+	{ 63, 31, 55, 23, 61, 29, 53, 21 }
+};
+
+static page_overlay_t overlay; // Drawn over every page of the next frame only
+static uint8_t banner_pages = 0; // Top pages of the display that frames leave alone
+
+static uint8_t transition_frames; // Zero when no transition is running
+static uint8_t transition_frame;
+
+// A byte is a column of 8 rows, so this frame's mask is the same 8 bytes repeated across every page
+static union {
+	uint8_t  bytes[8];
+	uint32_t words[2];
+} dither;
+
+static void dither_update(void) {
+	uint8_t level = (64 * (transition_frame + 1)) / transition_frames;
+
+	for (uint8_t col = 0; col < 8; col++) {
+		uint8_t bits = 0;
+
+		for (uint8_t row = 0; row < 8; row++) {
+			if (bayer[row][col] < level) {
+				bits |= 1 << row;
+			}
+		}
+		dither.bytes[col] = bits;
+	}
+}
+
+// Blends a frame into the displayed one over the next frames renders, starting from whatever was drawn last
+void render_transition(uint8_t frames) {
+	transition_frames = frames;
+	transition_frame = 0;
+
+	if (frames) {
+		dither_update();
+	}
+}
+
+bool render_transitioning(void) {
+	return transition_frames;
+}
+
+void render_overlay(page_overlay_t fn) {
+	overlay = fn;
+}
+
+static char *page_begin(uint8_t page) {
+	return transition_frames ? page_buffer : render_buffer + (page * 128);
+}
+
+// Four columns at a time, so even words take columns 0-3 of the dither mask and odd words columns 4-7
+static void page_end(uint8_t page) {
+	if (overlay) {
+		overlay(page, page_begin(page));
+	}
+	if (!transition_frames) {
+		return;
+	}
+	uint32_t       *out = render_words + (page * 32);
+	const uint32_t *in = page_words;
+
+	for (uint8_t i = 0; i < 32; i++) {
+		uint32_t bits = dither.words[i & 1];
+		out[i] = (out[i] & ~bits) | (in[i] & bits);
+	}
+}
+
+/* Reserves the top pages of the display for a banner drawn by the caller, such as a notice written with oled_write.
+ * Frames keep being rendered in full but only the pages below the banner are sent, and when the banner shrinks the
+ * pages it uncovers are put back from the last frame straight away.
+ */
+void render_banner(uint8_t pages) {
+	for (uint16_t i = pages * 128; i < banner_pages * 128; i++) {
+		oled_write_raw_byte(render_buffer[i], i);
+	}
+	banner_pages = pages;
+}
+
+/* Draws one line of text on each banner page as dark text on a solid background. The pages are cleared first since
+ * the font leaves the last columns of each row and anything past the text alone, then the whole banner is inverted
+ * through QMK's buffer so the background reaches both edges. Keep lines to 20 characters of the 6 pixel font so
+ * they can never wrap below the banner.
+ */
+void banner_draw(const char *const lines[]) {
+	for (uint16_t i = 0; i < banner_pages * 128; i++) {
+		oled_write_raw_byte(0, i);
+	}
+	for (uint8_t row = 0; row < banner_pages; row++) {
+		oled_set_cursor(0, row);
+		oled_write(lines[row], false);
+	}
+
+	oled_buffer_reader_t reader = oled_read_raw(0);
+	for (uint16_t i = 0; i < banner_pages * 128; i++) {
+		oled_write_raw_byte(~reader.current_element[i], i);
+	}
+}
+
+// Sets one byte of the frame for renderers that work a column at a time, blending it like page_end would
+static void frame_byte(uint16_t i, uint8_t byte) {
+	if (transition_frames) {
+		uint8_t bits = dither.bytes[i & 7];
+		byte = (render_buffer[i] & ~bits) | (byte & bits);
+	}
+	render_buffer[i] = byte;
+}
+
+static void frame_write(void) {
+	if (!banner_pages) {
+		oled_write_raw(render_buffer, 1024);
+		return;
+	}
+	for (uint16_t i = banner_pages * 128; i < 1024; i++) {
+		oled_write_raw_byte(render_buffer[i], i);
+	}
+}
+
+static void frame_end(void) {
+	frame_write();
+	overlay = NULL;
+
+	if (transition_frames) {
+		if (++transition_frame >= transition_frames) {
+			transition_frames = 0;
+		} else {
+			dither_update();
+		}
+	}
+}
+
+// ==========
+// = Assets =
+// ==========
+
+// Bit order reversed within a nibble, two lookups reverse a whole byte for ASSET_VFLIP
+static const uint8_t reverse_nibble[16] = {
+	0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+
+/* Returns one page of an asset with its transforms applied. A mirror or flip only changes which page and column a
+ * byte is read from, and a vertical flip also reverses the 8 pixels within the byte. Untransformed assets are read
+ * in place, so the renderers' per byte loops never look at the flags and only a transformed asset pays for copying
+ * its page into scratch.
+ */
+static const char *asset_page(asset_t asset, uint8_t page, char *scratch) {
+	if (!asset.flags) {
+		return asset.data + (page * 128);
+	}
+	
+	const char *in = asset.data + (((asset.flags & ASSET_VFLIP) ? 7 - page : page) * 128);
+	uint8_t     mirror = (asset.flags & ASSET_HMIRROR) ? 0x7F : 0;
+	uint8_t     invert = (asset.flags & ASSET_INVERT) ? 0xFF : 0;
+	
+	for (uint8_t col = 0; col < 128; col++) {
+		uint8_t byte = in[col ^ mirror];
+		
+		if (asset.flags & ASSET_VFLIP) {
+			byte = (reverse_nibble[byte & 0x0F] << 4) | reverse_nibble[byte >> 4];
+		}
+		scratch[col] = byte ^ invert;
+	}
+	return scratch;
+}
 
 // Writes two 128x64 images to the OLED, showing bitmap_high above row mask_y and bitmap_low below.
-void split_render(uint16_t mask_y, const char *bitmap_high, const char *bitmap_low) {
+void split_render(uint16_t mask_y, asset_t bitmap_high, asset_t bitmap_low) {
 	/* Images are represented as an array of bytes. The bytes are arranged horizontally LTR, however
 	 * each byte represents a vertical stack of 8 pixels (MSB is at the bottom, or equivalently
 	 * highest Y if 0,0 is top left). Therefore the exact ordering of bits in the array corresponds
@@ -29,28 +218,270 @@ void split_render(uint16_t mask_y, const char *bitmap_high, const char *bitmap_l
 	uint16_t colmask_y = ((mask_y * 16) / 128) * 128;
 	uint8_t  rowmask_y = ((1 << (mask_y - (mask_y / 8 * 8))) - 1);
 
-	for (uint16_t i = 0; i < 1024; i++) {
-		if (i < colmask_y) {
-			render_buffer[i] = bitmap_high[i];
-		} else if (i < (colmask_y + 128)) {
-			render_buffer[i] = (bitmap_low[i] & ~rowmask_y) | (bitmap_high[i] & rowmask_y);
+	char high_scratch[128];
+	char low_scratch[128];
+
+	for (uint8_t page = 0; page < 8; page++) {
+		char       *out = page_begin(page);
+		const char *high = asset_page(bitmap_high, page, high_scratch);
+		const char *low = asset_page(bitmap_low, page, low_scratch);
+
+		for (uint8_t col = 0; col < 128; col++) {
+			uint16_t i = (page * 128) + col;
+
+			if (i < colmask_y) {
+				out[col] = high[col];
+			} else if (i < (colmask_y + 128)) {
+				out[col] = (low[col] & ~rowmask_y) | (high[col] & rowmask_y);
+			} else {
+				out[col] = low[col];
+			}
+		}
+		page_end(page);
+	}
+	frame_end();
+}
+
+// =========
+// = Masks =
+// =========
+// One period of a sine wave scaled to +-127, for mask_waterline
+static const int8_t sine[32] = {
+	   0,   25,   49,   71,   90,  106,  117,  125,  127,  125,  117,  106,   90,   71,   49,   25,
+	   0,  -25,  -49,  -71,  -90, -106, -117, -125, -127, -125, -117, -106,  -90,  -71,  -49,  -25
+};
+
+static uint8_t clamp_row(int16_t y) {
+	return (y < 0) ? 0 : (y > 64) ? 64 : y;
+}
+
+// Integer square root, used by mask_iris to find each column's half height
+static uint8_t isqrt(uint16_t n) {
+	uint16_t root = 0;
+
+	for (uint16_t bit = 1 << 14; bit; bit >>= 2) {
+		if (n >= root + bit) {
+			n -= root + bit;
+			root = (root >> 1) + bit;
 		} else {
-			render_buffer[i] = bitmap_low[i];
+			root >>= 1;
 		}
 	}
-	oled_write_raw(render_buffer, 1024);
+	return root;
+}
+
+// Everything above a line at level that waves by amplitude rows, two periods across the screen. Advance phase by 1
+// each frame to move the waves left.
+void mask_waterline(mask_t *mask, uint8_t level, uint8_t amplitude, uint8_t phase) {
+	for (uint8_t col = 0; col < 128; col++) {
+		mask->top[col] = 0;
+		mask->bottom[col] = clamp_row(level + ((sine[(phase + (col / 2)) & 31] * amplitude) / 127));
+	}
+}
+
+// A circle that opens from its center as the radius grows, a radius of 72 covers the screen from its middle and a
+// radius of 0 is fully closed
+void mask_iris(mask_t *mask, uint8_t center_x, uint8_t center_y, uint8_t radius) {
+	for (uint8_t col = 0; col < 128; col++) {
+		int16_t dx = col - center_x;
+
+		if (!radius || (dx < -radius) || (dx > radius)) {
+			mask->top[col] = 0;
+			mask->bottom[col] = 0;
+		} else {
+			uint8_t half = isqrt((radius * radius) - (dx * dx));
+			mask->top[col] = clamp_row(center_y - half);
+			mask->bottom[col] = clamp_row(center_y + half + 1);
+		}
+	}
+}
+
+// Everything above a straight line from left_y on the first column to right_y on the last, which may be off screen
+void mask_diagonal(mask_t *mask, int16_t left_y, int16_t right_y) {
+	for (uint8_t col = 0; col < 128; col++) {
+		mask->top[col] = 0;
+		mask->bottom[col] = clamp_row(left_y + (((right_y - left_y) * col) / 127));
+	}
+}
+
+/* Each page covers rows 8 * page to 8 * page + 7, so a column's span is clipped to the page and turned into the bits
+ * from lo up to hi - 1 with two shifts. This is the colmask/rowmask idea from split_render done for every column.
+ */
+void mask_render(const mask_t *mask, asset_t bitmap_high, asset_t bitmap_low) {
+	char high_scratch[128];
+	char low_scratch[128];
+
+	for (uint8_t page = 0; page < 8; page++) {
+		char       *out = page_begin(page);
+		const char *high = asset_page(bitmap_high, page, high_scratch);
+		const char *low = asset_page(bitmap_low, page, low_scratch);
+		int8_t      base = page * 8;
+
+		for (uint8_t col = 0; col < 128; col++) {
+			int8_t lo = mask->top[col] - base;
+			int8_t hi = mask->bottom[col] - base;
+			lo = (lo < 0) ? 0 : (lo > 8) ? 8 : lo;
+			hi = (hi < 0) ? 0 : (hi > 8) ? 8 : hi;
+
+			uint8_t bits = (0xFF >> (8 - hi)) & (0xFF << lo);
+
+			out[col] = (low[col] & ~bits) | (high[col] & bits);
+		}
+		page_end(page);
+	}
+	frame_end();
+}
+
+// Shows bitmap_high wherever a bit of the mask bitmap is set, which can itself be transformed like any other asset
+void bitmap_mask_render(asset_t mask, asset_t bitmap_high, asset_t bitmap_low) {
+	char mask_scratch[128];
+	char high_scratch[128];
+	char low_scratch[128];
+
+	for (uint8_t page = 0; page < 8; page++) {
+		char       *out = page_begin(page);
+		const char *bits = asset_page(mask, page, mask_scratch);
+		const char *high = asset_page(bitmap_high, page, high_scratch);
+		const char *low = asset_page(bitmap_low, page, low_scratch);
+
+		for (uint8_t col = 0; col < 128; col++) {
+			out[col] = (low[col] & ~bits[col]) | (high[col] & bits[col]);
+		}
+		page_end(page);
+	}
+	frame_end();
 }
 
 void h_scroll_render(uint16_t offset_x, const char *bitmap, uint16_t bitmap_width) {
 	for (uint16_t row = 0; row < (64 / 8); row++) {
+		char *out = page_begin(row);
+
 		for (uint16_t col = 0; col < 128; col++) {
-			render_buffer[(row * 128) + col] = bitmap[(row * bitmap_width) + (col + offset_x) % bitmap_width];
+			out[col] = bitmap[(row * bitmap_width) + (col + offset_x) % bitmap_width];
 		}
+		page_end(row);
 	}
 	
-	oled_write_raw(render_buffer, 1024);
+	frame_end();
+}
+
+// An empty frame, for modes that only draw an overlay
+void blank_render(void) {
+	for (uint8_t page = 0; page < 8; page++) {
+		memset(page_begin(page), 0, 128);
+		page_end(page);
+	}
+	frame_end();
+}
+
+/* Shifts the last frame left by columns in the render buffer and only works out the newly exposed columns on the
+ * right. Column returns the 64 pixels of column x with bit 0 at the top and is called once for each column drawn.
+ * Pass 128 to draw every column, which also happens during a transition since the buffer then holds a blend rather
+ * than the last graph. Overlays are not drawn, as they would be scrolled along with the frame.
+ *
+ * This is a full frame fallback as far as the display is concerned. The shift is done in software and moves every
+ * byte, so all 1024 bytes are written and sent on every frame just like the other renderers. Only the column
+ * function calls for columns already drawn are saved.
+ */
+void scroll_render(uint8_t columns, column_fn_t column) {
+	overlay = NULL;
+
+	if (transition_frames || (columns > 128)) {
+		columns = 128;
+	}
+	uint8_t first = 128 - columns;
+
+	if (first) {
+		for (uint8_t page = 0; page < 8; page++) {
+			memmove(render_buffer + (page * 128), render_buffer + (page * 128) + columns, first);
+		}
+	}
+	for (uint8_t x = first; x < 128; x++) {
+		uint64_t bits = column(x);
+
+		for (uint8_t page = 0; page < 8; page++) {
+			frame_byte((page * 128) + x, bits >> (page * 8));
+		}
+	}
+	frame_end();
 }
 
+// ==========
+// = Gauges =
+// ==========
+// Digits are centred above the bar, with a scale under the bar marking each quarter
+#define GAUGE_DIGITS   3
+#define GAUGE_X        ((128 - (GAUGE_DIGITS * BIG_DIGIT_WIDTH)) / 2)
+#define GAUGE_PAGE     1
+#define GAUGE_BAR_PAGE 6
+#define GAUGE_BAR      0x7E
+
+static uint8_t gauge_digits[GAUGE_DIGITS]; // What each cell shows, 10 for blank
+static uint8_t gauge_bar;
+
+// Writes a byte to both the render buffer and the display, so the render buffer still holds the last frame shown
+static void gauge_write(uint8_t byte, uint16_t i) {
+	if (render_buffer[i] != (char)byte) {
+		render_buffer[i] = byte;
+
+		if (i >= banner_pages * 128) {
+			oled_write_raw_byte(byte, i);
+		}
+	}
+}
+
+static void gauge_cell(uint8_t cell, uint8_t digit) {
+	const char *glyph = BIG_DIGITS + (digit * BIG_DIGIT_WIDTH * BIG_DIGIT_PAGES);
+
+	for (uint8_t page = 0; page < BIG_DIGIT_PAGES; page++) {
+		for (uint8_t col = 0; col < BIG_DIGIT_WIDTH; col++) {
+			uint16_t i = ((GAUGE_PAGE + page) * 128) + GAUGE_X + (cell * BIG_DIGIT_WIDTH) + col;
+			gauge_write((digit < 10) ? glyph[(page * BIG_DIGIT_WIDTH) + col] : 0, i);
+		}
+	}
+	gauge_digits[cell] = digit;
+}
+
+/* Shows value as big digits over a bar filled in proportion to max. Rather than rewriting the frame, only digit
+ * cells that changed and the end of the bar that moved are written, so a steady value costs nothing and a change
+ * costs a few hundred bytes. Pass redraw when the display was showing anything else. Transitions are cancelled, as
+ * there is no frame to blend.
+ */
+void gauge_render(uint16_t value, uint16_t max, bool redraw) {
+	render_transition(0);
+	overlay = NULL;
+
+	if (value > 999) {
+		value = 999;
+	}
+	if (redraw) {
+		memset(render_buffer, 0, 1024);
+		for (uint8_t col = 0; col < 128; col++) {
+			render_buffer[((GAUGE_BAR_PAGE + 1) * 128) + col] = ((col % 32 == 0) || (col == 127)) ? 0x07 : 0x01;
+		}
+		frame_write();
+
+		memset(gauge_digits, 10, sizeof(gauge_digits));
+		gauge_bar = 0;
+	}
+
+	// Leading zeros are left blank but a value of 0 still shows one digit
+	uint16_t rest = value;
+	for (int8_t cell = GAUGE_DIGITS - 1; cell >= 0; cell--) {
+		uint8_t digit = ((rest == 0) && (cell != GAUGE_DIGITS - 1)) ? 10 : rest % 10;
+		rest /= 10;
+
+		if (gauge_digits[cell] != digit) {
+			gauge_cell(cell, digit);
+		}
+	}
+
+	uint8_t bar = (value >= max) ? 128 : (value * 128) / max;
+	for (uint8_t col = (bar < gauge_bar) ? bar : gauge_bar; col < ((bar > gauge_bar) ? bar : gauge_bar); col++) {
+		gauge_write((col < bar) ? GAUGE_BAR : 0, (GAUGE_BAR_PAGE * 128) + col);
+	}
+	gauge_bar = bar;
+}
 
 // Bitmaps must have a height that is a multiple of 8 or the loop will not be seamless
 void v_scroll_render(uint16_t offset_y, const char *bitmap, uint16_t bitmap_height) {
@@ -59,14 +490,16 @@ void v_scroll_render(uint16_t offset_y, const char *bitmap, uint16_t bitmap_heig
 	for (uint16_t row = 0; row < (64 / 8); row++) {
 		uint16_t row_index = (row + offset_y / 8) % ((bitmap_height) / 8);
 		uint16_t next_row_index = (row_index + 1) % ((bitmap_height) / 8);
+		char    *out = page_begin(row);
 			
 		for (uint16_t col = 0; col < 128; col++) {
-			render_buffer[(row * 128) + col] = (bitmap[(row_index * 128) + col] >> shift) |
-											   (bitmap[(next_row_index * 128) + col] << (8 - shift));
+			out[col] = (bitmap[(row_index * 128) + col] >> shift) |
+					   (bitmap[(next_row_index * 128) + col] << (8 - shift));
 		}
+		page_end(row);
 	}
 	
-	oled_write_raw(render_buffer, 1024);
+	frame_end();
 }
 
 /* Convert images using:
@@ -2441,4 +2874,61 @@ const char PROGMEM CHARACTERS[] = {
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x04, 0x0c, 0x17, 0x16, 0x12, 
 	0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
-};
\ No newline at end of file
+};
+
+/* Seven segment digits 0-9 for gauge_render, each BIG_DIGIT_WIDTH columns by BIG_DIGIT_PAGES pages in page layout.
+ * Every digit is made of the same segment shapes, so restyling one segment means changing it in each digit that
+ * lights it.
+ */
+const char PROGMEM BIG_DIGITS[] = {
+	// 0
+	0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xec, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0xec, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x3f, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0xfc, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x07, 0x0f, 0x0f, 0x37, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x37, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 1
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 2
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0xec, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xbf, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0xfc, 0xfe, 0xfe, 0xfd, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x07, 0x0f, 0x0f, 0x37, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	// 3
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0xec, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xbf, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xfd, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x37, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 4
+	0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x3f, 0x7f, 0x7f, 0xbf, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xbf, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xfd, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 5
+	0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xec, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x3f, 0x7f, 0x7f, 0xbf, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xfd, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x37, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 6
+	0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xec, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x3f, 0x7f, 0x7f, 0xbf, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0xfc, 0xfe, 0xfe, 0xfd, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xfd, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x07, 0x0f, 0x0f, 0x37, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x37, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 7
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0xec, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 8
+	0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xec, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0xec, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x3f, 0x7f, 0x7f, 0xbf, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xbf, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0xfc, 0xfe, 0xfe, 0xfd, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xfd, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x07, 0x0f, 0x0f, 0x37, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x37, 0x0f, 0x0f, 0x07, 0x00, 0x00, 
+	// 9
+	0x00, 0x00, 0xe0, 0xf0, 0xf0, 0xec, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0x1e, 0xec, 0xf0, 0xf0, 0xe0, 0x00, 0x00, 
+	0x00, 0x00, 0x3f, 0x7f, 0x7f, 0xbf, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xbf, 0x7f, 0x7f, 0x3f, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xfd, 0xfe, 0xfe, 0xfc, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x78, 0x37, 0x0f, 0x0f, 0x07, 0x00, 0x00
+};
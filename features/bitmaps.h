@@ -1,7 +1,8 @@
 /* bitmaps.h
  *
  * Header file for bitmap rendering on OLED displays in keyboard firmware.
- * Declares the split_render function and provides external references to bitmap data arrays for use across the firmware.
+ * Declares the split_render function and asset transforms, and provides external references to bitmap data arrays for use
+ * across the firmware.
  *
  * Author: Ryan Turner
  */
@@ -10,9 +11,57 @@
 
 #include "quantum.h"
 
-void split_render(uint16_t mask, const char *bitmap_full, const char *bitmap_front);
+/* A 128x64 bitmap along with transforms to apply as it is drawn. Use ASSET for a bitmap as stored and ASSET_FLAGS
+ * to derive a variant at render time instead of storing another 1KB copy.
+ */
+#define ASSET_INVERT  1
+#define ASSET_HMIRROR 2
+#define ASSET_VFLIP   4
+#define ASSET_ROT180  (ASSET_HMIRROR | ASSET_VFLIP)
+
+typedef struct {
+	const char *data;
+	uint8_t     flags;
+} asset_t;
+
+#define ASSET(data) ((asset_t){data, 0})
+#define ASSET_FLAGS(data, flags) ((asset_t){data, flags})
+
+void split_render(uint16_t mask, asset_t bitmap_full, asset_t bitmap_front);
+
+// Dithers from the last frame drawn into the next one over the given number of frames, which any renderer can draw
+void render_transition(uint8_t frames);
+bool render_transitioning(void);
+
+/* Called with each page of the next frame after the renderer has drawn it, so sprites can be drawn over any
+ * background. Set it again before every frame that should have it.
+ */
+typedef void (*page_overlay_t)(uint8_t page, char *out);
+void render_overlay(page_overlay_t fn);
+void render_banner(uint8_t pages);
+void banner_draw(const char *const lines[]);
+
+/* Masks for mask_render, which shows the high bitmap in rows top to bottom - 1 of each column and the low bitmap
+ * everywhere else. Fill one using a producer each frame, then render it.
+ */
+typedef struct {
+	uint8_t top[128];
+	uint8_t bottom[128];
+} mask_t;
+
+void mask_waterline(mask_t *mask, uint8_t level, uint8_t amplitude, uint8_t phase);
+void mask_iris(mask_t *mask, uint8_t center_x, uint8_t center_y, uint8_t radius);
+void mask_diagonal(mask_t *mask, int16_t left_y, int16_t right_y);
+
+void mask_render(const mask_t *mask, asset_t bitmap_high, asset_t bitmap_low);
+void bitmap_mask_render(asset_t mask, asset_t bitmap_high, asset_t bitmap_low);
 void h_scroll_render(uint16_t offset_x, const char *bitmap, uint16_t bitmap_width);
 void v_scroll_render(uint16_t offset_x, const char *bitmap, uint16_t bitmap_width);
+void blank_render(void);
+
+typedef uint64_t (*column_fn_t)(uint8_t x);
+void scroll_render(uint8_t columns, column_fn_t column);
+void gauge_render(uint16_t value, uint16_t max, bool redraw);
 
 extern const char PROGMEM TOTORO_FRONT[];
 extern const char PROGMEM TOTORO_FULL[];
@@ -43,3 +92,7 @@ extern const char PROGMEM CAT_SCROLL[];
 
 # define CHARACTERS_HEIGHT 832
 extern const char PROGMEM CHARACTERS[];
+
+# define BIG_DIGIT_WIDTH 24
+# define BIG_DIGIT_PAGES 4
+extern const char PROGMEM BIG_DIGITS[];
@@ -0,0 +1,61 @@
+/* histogram.c
+ *
+ * Linear histograms that keep enough about a stream of latencies to show the mean, the worst case and percentiles to
+ * within one bucket, in about 40 bytes each. Each histogram picks its own bucket width, so tap dance decisions can be
+ * told apart 20 ms at a time across the tapping term while scan intervals use 1 ms buckets. Counters halve together
+ * when one of them is about to overflow, so a histogram left running for weeks keeps its shape and favours recent
+ * samples.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "histogram.h"
+
+static void halve(hist_t *hist) {
+	hist->count = 0;
+	for (uint8_t i = 0; i < HIST_BUCKETS; i++) {
+		hist->bucket[i] >>= 1;
+		hist->count += hist->bucket[i];
+	}
+	hist->sum >>= 1;
+}
+
+void hist_add(hist_t *hist, uint16_t value) {
+	uint16_t bucket = value / hist->width;
+
+	if (bucket > HIST_BUCKETS - 1) {
+		bucket = HIST_BUCKETS - 1;
+	}
+
+	if ((hist->count == UINT16_MAX) || (hist->sum > UINT32_MAX - value)) {
+		halve(hist);
+	}
+
+	hist->bucket[bucket]++;
+	hist->count++;
+	hist->sum += value;
+	if (value > hist->max) {
+		hist->max = value;
+	}
+}
+
+uint16_t hist_mean(const hist_t *hist) {
+	return hist->count ? hist->sum / hist->count : 0;
+}
+
+/* Returns the upper bound of the bucket holding the percentile, or the maximum for the open ended last bucket. The
+ * bound is never more than the largest value seen, which can sit anywhere inside its bucket.
+ */
+uint16_t hist_percentile(const hist_t *hist, uint8_t percent) {
+	uint32_t target = ((uint32_t)hist->count * percent + 99) / 100;
+	uint32_t seen = 0;
+
+	for (uint8_t i = 0; i < HIST_BUCKETS - 1; i++) {
+		seen += hist->bucket[i];
+		if (seen && (seen >= target)) {
+			uint16_t bound = (i + 1) * hist->width;
+			return (bound < hist->max) ? bound : hist->max;
+		}
+	}
+	return hist->max;
+}
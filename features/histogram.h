@@ -0,0 +1,32 @@
+/* histogram.h
+ *
+ * Header file for compact latency histograms in keyboard firmware.
+ * Declares a histogram with evenly spaced buckets along with its count, sum and maximum, and functions to add a
+ * sample and read back the mean and percentiles.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Bucket i holds values from i * width up to (i + 1) * width. The last bucket holds everything from
+ * (HIST_BUCKETS - 1) * width upwards, which is 300 ms and above for tap dance decisions in 20 ms buckets.
+ */
+#define HIST_BUCKETS 16
+
+// Histograms must be created with a bucket width, for example static hist_t wait = HIST_INIT(20);
+#define HIST_INIT(bucket_width) { .width = (bucket_width) }
+
+typedef struct {
+	uint16_t bucket[HIST_BUCKETS];
+	uint16_t count;
+	uint16_t max;
+	uint32_t sum;
+	uint8_t  width; // Range of values in each bucket
+} hist_t;
+
+void hist_add(hist_t *hist, uint16_t value);
+uint16_t hist_mean(const hist_t *hist);
+uint16_t hist_percentile(const hist_t *hist, uint8_t percent);
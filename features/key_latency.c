@@ -0,0 +1,109 @@
+/* key_latency.c
+ *
+ * Measures how long a key takes to reach the host, from the matrix scan that saw the press to the keyboard report
+ * that carries it being handed to the USB driver. Each path through the keymap has its own histogram so tap dance
+ * and macro changes can be compared against plain keys.
+ *
+ * A path is armed with its press's record->event.time at the moment it decides to send something, so time spent
+ * before process_record_user, such as in other keys' callbacks, is counted too. The next keyboard report within
+ * KEY_LATENCY_WINDOW completes the measurement. Decisions that never send a report, such as a layer change, expire
+ * instead and are only counted.
+ *
+ * Reports are seen by wrapping send_keyboard and send_nkro in QMK's host driver, so keys are timed with NKRO on or off.
+ * The driver is checked every scan because QMK only installs it after keyboard_post_init_user.
+ *
+ * Call key_latency_task from matrix_scan_user.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "key_latency.h"
+#include "quantum.h"
+
+#ifndef KEY_LATENCY_WINDOW
+#define KEY_LATENCY_WINDOW 20 // Longest time from arming to the report before the measurement is dropped, in ms
+#endif
+
+const char *const key_path_names[KL_PATH_COUNT] = {
+	[KL_PLAIN]       = "Plain",
+	[KL_TAP_HOLD]    = "TapHold",
+	[KL_QUAD]        = "Quad",
+	[KL_SELECT_WORD] = "SelWord",
+	[KL_MACRO]       = "Macro",
+};
+
+typedef struct {
+	bool     armed;
+	uint16_t start;    // Event time of the press
+	uint16_t armed_at; // When the path decided to send a report
+} key_pending_t;
+
+// Tap dances are timed from the first press so they take most of a tapping term, other paths take a few ms
+static hist_t latency[KL_PATH_COUNT] = {
+	[KL_PLAIN]       = HIST_INIT(1),
+	[KL_TAP_HOLD]    = HIST_INIT(20),
+	[KL_QUAD]        = HIST_INIT(20),
+	[KL_SELECT_WORD] = HIST_INIT(1),
+	[KL_MACRO]       = HIST_INIT(1),
+};
+
+static key_pending_t pending[KL_PATH_COUNT];
+static uint16_t      expired = 0;
+
+static host_driver_t  hooked_driver;
+static host_driver_t *host_driver = NULL;
+
+static void key_latency_report(void) {
+	uint16_t now = timer_read();
+
+	for (uint8_t path = 0; path < KL_PATH_COUNT; path++) {
+		if (!pending[path].armed) {
+			continue;
+		}
+		pending[path].armed = false;
+
+		if (TIMER_DIFF_16(now, pending[path].armed_at) <= KEY_LATENCY_WINDOW) {
+			hist_add(&latency[path], TIMER_DIFF_16(now, pending[path].start));
+		} else if (expired < UINT16_MAX) {
+			expired++;
+		}
+	}
+}
+
+static void send_keyboard_hooked(report_keyboard_t *report) {
+	key_latency_report();
+	host_driver->send_keyboard(report);
+}
+
+static void send_nkro_hooked(report_nkro_t *report) {
+	key_latency_report();
+	host_driver->send_nkro(report);
+}
+
+void key_latency_task(void) {
+	host_driver_t *driver = host_get_driver();
+
+	if (driver && (driver != &hooked_driver)) {
+		host_driver = driver;
+		hooked_driver = *driver;
+		hooked_driver.send_keyboard = send_keyboard_hooked;
+		if (driver->send_nkro) {
+			hooked_driver.send_nkro = send_nkro_hooked;
+		}
+		host_set_driver(&hooked_driver);
+	}
+}
+
+void key_latency_arm(key_path_t path, uint16_t start) {
+	pending[path].armed = true;
+	pending[path].start = start;
+	pending[path].armed_at = timer_read();
+}
+
+const hist_t *key_latency(key_path_t path) {
+	return &latency[path];
+}
+
+uint16_t key_latency_expired(void) {
+	return expired;
+}
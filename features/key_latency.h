@@ -0,0 +1,30 @@
+/* key_latency.h
+ *
+ * Header file for measuring key to report latency in keyboard firmware.
+ * Declares the paths a key can take to the host, and functions to mark a press as waiting for its report and read
+ * back the latency histogram of each path.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "histogram.h"
+
+typedef enum {
+	KL_PLAIN,       // Keycodes sent straight from the keymap
+	KL_TAP_HOLD,    // ACTION_TAP_DANCE_TAP_HOLD
+	KL_QUAD,        // ACTION_TAP_DANCE_TRI and QUAD
+	KL_SELECT_WORD,
+	KL_MACRO,
+	KL_PATH_COUNT
+} key_path_t;
+
+extern const char *const key_path_names[KL_PATH_COUNT];
+
+void key_latency_task(void);
+void key_latency_arm(key_path_t path, uint16_t start);
+
+const hist_t *key_latency(key_path_t path);
+uint16_t key_latency_expired(void);
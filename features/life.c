@@ -0,0 +1,150 @@
+/* life.c
+ *
+ * Conway's Game of Life on a 128x64 grid that wraps at the edges, stored in the same page layout as the OLED
+ * framebuffer. Each byte is 8 cells stacked vertically, so a 32 bit word is 4 columns of 8 rows and a whole word is
+ * stepped at once with bit-sliced adders: the 8 neighbour words are found by shifting bytes within the word for the
+ * columns either side and bits within each byte for the rows above and below, then counted bit by bit into a
+ * running total.
+ *
+ * The grid is updated in place one page at a time. Only the old copies of the page above and of page 0, which the
+ * last page wraps around to, need keeping, so a generation needs 256 extra bytes.
+ *
+ * Call life_step once per frame, then draw the grid with life_cells as the mask of bitmap_mask_render.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "life.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define LIFE_WORDS 32 // Words in one page of 128 columns
+
+static uint32_t grid[8][LIFE_WORDS];
+static uint32_t prev_page[LIFE_WORDS];  // Old page p - 1 while page p is stepped
+static uint32_t first_page[LIFE_WORDS]; // Old page 0, which is below page 7
+static bool seeded = false;
+
+static uint16_t rng_state = 0x1D2B;
+
+static uint16_t rng(void) {
+	rng_state ^= rng_state << 7;
+	rng_state ^= rng_state >> 9;
+	rng_state ^= rng_state << 8;
+	return rng_state;
+}
+
+// A random soup with roughly one cell in four alive
+void life_seed(void) {
+	for (uint8_t page = 0; page < 8; page++) {
+		for (uint8_t w = 0; w < LIFE_WORDS; w++) {
+			uint32_t a = ((uint32_t)rng() << 16) | rng();
+			uint32_t b = ((uint32_t)rng() << 16) | rng();
+			grid[page][w] = a & b;
+		}
+	}
+	seeded = true;
+}
+
+uint16_t life_population(void) {
+	uint16_t count = 0;
+
+	for (uint8_t page = 0; page < 8; page++) {
+		for (uint8_t w = 0; w < LIFE_WORDS; w++) {
+			count += __builtin_popcountl(grid[page][w]);
+		}
+	}
+	return count;
+}
+
+// A glider heading down and right with its top left corner at x, y
+void life_inject(uint8_t x, uint8_t y) {
+	static const uint8_t glider[3] = {0b010, 0b100, 0b111}; // Rows, bit 0 is the leftmost column
+
+	uint8_t *cells = (uint8_t *)grid;
+
+	for (uint8_t row = 0; row < 3; row++) {
+		for (uint8_t col = 0; col < 3; col++) {
+			if (glider[row] & (1 << col)) {
+				uint8_t cx = (x + col) & 127;
+				uint8_t cy = (y + row) & 63;
+				cells[((cy / 8) * 128) + cx] |= 1 << (cy & 7);
+			}
+		}
+	}
+}
+
+// Byte k of a word is column 4w + k, so the cell to the left of each column comes from one byte lower
+static inline uint32_t from_left(const uint32_t *page, uint8_t w) {
+	return (page[w] << 8) | (page[(w - 1) & (LIFE_WORDS - 1)] >> 24);
+}
+
+static inline uint32_t from_right(const uint32_t *page, uint8_t w) {
+	return (page[w] >> 8) | (page[(w + 1) & (LIFE_WORDS - 1)] << 24);
+}
+
+// Bit r of each byte is row r, the top row of each byte comes from the bottom row of the page above
+static inline uint32_t from_above(uint32_t word, uint32_t above) {
+	return ((word << 1) & 0xFEFEFEFE) | ((above >> 7) & 0x01010101);
+}
+
+static inline uint32_t from_below(uint32_t word, uint32_t below) {
+	return ((word >> 1) & 0x7F7F7F7F) | ((below << 7) & 0x80808080);
+}
+
+/* Adds one neighbour word to a count kept as bit slices, s0 and s1 are the low bits and s2 is set once the count
+ * reaches 4. Nothing past 3 changes the outcome, so s2 never needs to carry further.
+ */
+#define LIFE_ADD(x) do {          \
+	uint32_t c0 = s0 & (x);       \
+	s0 ^= (x);                    \
+	s2 |= s1 & c0;                \
+	s1 ^= c0;                     \
+} while (0)
+
+void life_step(void) {
+	if (!seeded) {
+		life_seed();
+	}
+
+	memcpy(first_page, grid[0], sizeof(first_page));
+	memcpy(prev_page, grid[7], sizeof(prev_page));
+
+	for (uint8_t page = 0; page < 8; page++) {
+		const uint32_t *above = prev_page;
+		const uint32_t *below = (page == 7) ? first_page : grid[page + 1];
+		uint32_t        next[LIFE_WORDS];
+
+		for (uint8_t w = 0; w < LIFE_WORDS; w++) {
+			uint32_t cell = grid[page][w];
+			uint32_t left = from_left(grid[page], w);
+			uint32_t right = from_right(grid[page], w);
+			uint32_t left_above = from_left(above, w);
+			uint32_t right_above = from_right(above, w);
+			uint32_t left_below = from_left(below, w);
+			uint32_t right_below = from_right(below, w);
+
+			uint32_t s0 = 0, s1 = 0, s2 = 0;
+
+			LIFE_ADD(left);
+			LIFE_ADD(right);
+			LIFE_ADD(from_above(cell, above[w]));
+			LIFE_ADD(from_below(cell, below[w]));
+			LIFE_ADD(from_above(left, left_above));
+			LIFE_ADD(from_below(left, left_below));
+			LIFE_ADD(from_above(right, right_above));
+			LIFE_ADD(from_below(right, right_below));
+
+			// Born with exactly 3 neighbours, survives with 2 or 3
+			next[w] = ~s2 & s1 & (s0 | cell);
+		}
+
+		memcpy(prev_page, grid[page], sizeof(prev_page));
+		memcpy(grid[page], next, sizeof(next));
+	}
+}
+
+// The grid as a 128x64 bitmap in page layout, which is how the words are laid out in memory
+const char *life_cells(void) {
+	return (const char *)grid;
+}
@@ -0,0 +1,17 @@
+/* life.h
+ *
+ * Header file for Conway's Game of Life on the OLED in keyboard firmware.
+ * Declares functions to step the grid, read it as a bitmap for bitmaps.c and add cells from key presses.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+void life_step(void);
+const char *life_cells(void);
+void life_inject(uint8_t x, uint8_t y);
+void life_seed(void);
+uint16_t life_population(void);
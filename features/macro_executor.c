@@ -0,0 +1,434 @@
+/* macro_executor.c
+ *
+ * Plays SEND_STRING macros without blocking the keyboard. send_string_with_delay types the whole string in one call,
+ * including every SS_DELAY, so matrix scanning and the OLED stop until it returns. This executor instead interprets
+ * the same byte stream a few steps at a time from a scheduler task. Every key press and release is its own step,
+ * SS_DELAY becomes the delay until the task runs again, and control returns to the main loop between reports.
+ *
+ * Runs of plain text are batched: up to six distinct keys that share the same shift state are pressed in one 6KRO
+ * report and released in the next, so text types several times faster at the same polling rate. With NKRO the batch
+ * can be larger as long as the keys are in keycode order.
+ *
+ * Presses that arrive while a macro is playing wait in a small fixed-size queue instead of being dropped. Each press
+ * carries a macro_policy_t that decides whether it queues, merges with an identical pending macro or cancels
+ * everything before it. Counters for queued, dropped, coalesced and cancelled presses and for the time spent waiting
+ * are available from macro_queue_stats.
+ *
+ * Requires task_scheduler.c, with sched_run called from housekeeping_task_user.
+ *
+ * Besides QMK's SEND_STRING codes the executor understands the compact opcodes built by send_string_macros.h. SS_REPT
+ * loops over its body at runtime instead of repeating it in flash, and SS_CALL plays one of the shared sequences in
+ * macro_subroutines, which the keymap must define when MACRO_SHARED_SEQUENCES is set. A loop count or subroutine
+ * that does not exist, or nesting deeper than MACRO_STACK_DEPTH, stops the macro instead of typing on.
+ *
+ * Define MACRO_EXEC_STEPS in config.h to change how many reports are sent each time the task runs.
+ * Define MACRO_QUEUE_SIZE in config.h to change how many macros can wait at once.
+ * Define MACRO_BATCH_KEYS 1 in config.h to type plain text one key per report like send_string does.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "macro_executor.h"
+#include "send_string_macros.h"
+#include "task_scheduler.h"
+#include "quantum.h"
+
+#ifndef MACRO_EXEC_STEPS
+#define MACRO_EXEC_STEPS 2
+#endif
+
+#ifndef MACRO_QUEUE_SIZE
+#define MACRO_QUEUE_SIZE 4
+#endif
+
+typedef struct {
+	const char *macro;
+	uint8_t     interval;
+	uint32_t    time; // When the macro was queued
+} macro_queue_entry_t;
+
+static macro_queue_entry_t queue[MACRO_QUEUE_SIZE];
+static uint8_t queue_head = 0;
+static uint8_t queue_count = 0;
+
+static macro_queue_stats_t stats = {0};
+
+#ifndef MACRO_BATCH_KEYS
+#define MACRO_BATCH_KEYS 6
+#endif
+
+#ifndef MACRO_BATCH_KEYS_NKRO
+#define MACRO_BATCH_KEYS_NKRO 16
+#endif
+
+#ifndef MACRO_STACK_DEPTH
+#define MACRO_STACK_DEPTH 4
+#endif
+
+#define MACRO_BATCH_MAX ((MACRO_BATCH_KEYS_NKRO > MACRO_BATCH_KEYS) ? MACRO_BATCH_KEYS_NKRO : MACRO_BATCH_KEYS)
+
+static const char *playing = NULL;    // Start of the macro being played, for MQ_COALESCE
+static const char *cursor = NULL;     // Next byte of the macro to interpret
+static uint8_t     interval = 0;      // Delay between reports, as passed to send_string_with_delay
+static uint8_t     held_keys[MACRO_BATCH_MAX]; // Keys pressed by the last step whose release has not been sent yet
+static uint8_t     held_count = 0;
+static uint8_t     held_mods = 0;     // Weak mods that were added for held_keys
+static bool        held_batch = false; // held_keys were added to the report directly instead of registered
+static bool        held_dead = false;
+
+// Open SS_REPT loops and SS_CALL subroutines
+typedef struct {
+	const char *pos;       // Start of the loop body, or where to return to after a subroutine
+	uint8_t     remaining; // Loop iterations left after the current one, unused for subroutines
+	bool        call;
+} macro_frame_t;
+
+static macro_frame_t stack[MACRO_STACK_DEPTH];
+static uint8_t       depth = 0;
+
+// Same bit packing as PGM_LOADBIT in send_string.c
+static bool ascii_bit(const uint8_t *lut, char ascii) {
+	return (pgm_read_byte(&lut[(uint8_t)ascii / 8]) >> ((uint8_t)ascii % 8)) & 0x01;
+}
+
+static uint8_t ascii_mods(char ascii) {
+	uint8_t mods = 0;
+
+	if (ascii_bit(ascii_to_shift_lut, ascii)) mods |= MOD_BIT(KC_LEFT_SHIFT);
+	if (ascii_bit(ascii_to_altgr_lut, ascii)) mods |= MOD_BIT(KC_RIGHT_ALT);
+	return mods;
+}
+
+static bool is_held(uint8_t keycode) {
+	for (uint8_t i = 0; i < held_count; i++) {
+		if (held_keys[i] == keycode) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* Returns how many keys a batch may press at once. With NKRO the bitmap has room for every key, but it also has no
+ * order of its own so *ordered is set and the batch must be sorted by keycode to type in the right order. Otherwise
+ * the batch may only use the free slots of the 6KRO report, which hosts read in array order.
+ */
+static uint8_t batch_limit(bool *ordered) {
+	*ordered = false;
+#ifdef NKRO_ENABLE
+	if (keyboard_protocol && keymap_config.nkro) {
+		*ordered = true;
+		return MACRO_BATCH_KEYS_NKRO;
+	}
+#endif
+	uint8_t free = 0;
+	for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+		if (!keyboard_report->keys[i]) {
+			free++;
+		}
+	}
+	if (!free) {
+		return 1; // Let add_key decide, as send_char would
+	}
+	return (free < MACRO_BATCH_KEYS) ? free : MACRO_BATCH_KEYS;
+}
+
+// Presses a key and remembers it so the release can be sent from the next step
+static void press_key(uint8_t keycode, uint8_t mods) {
+	held_keys[0] = keycode;
+	held_count = 1;
+	held_mods = mods;
+	held_batch = false;
+
+	add_weak_mods(mods);
+	register_code(keycode);
+}
+
+/* Equivalent to send_char for a run of characters, sending one report for the presses and one for the releases.
+ * The run ends before a character that needs different mods, repeats a key already in the run, or would break the
+ * NKRO ordering. A dead key always ends the run since it needs a space tapped after it.
+ */
+static void press_chars(void) {
+	bool    ordered;
+	uint8_t limit = batch_limit(&ordered);
+	uint8_t mods = ascii_mods(*cursor);
+
+	held_count = 0;
+	held_mods = mods;
+	held_batch = true;
+
+	while (*cursor && (*cursor != SS_QMK_PREFIX) && (held_count < limit)) {
+		char    ascii = *cursor;
+		uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii]);
+		bool    dead = ascii_bit(ascii_to_dead_lut, ascii);
+
+		if ((ascii_mods(ascii) != mods) || (dead && held_count) || is_held(keycode)) break;
+		if (ordered && held_count && (keycode < held_keys[held_count - 1])) break;
+
+		cursor++;
+		if (!keycode) {
+			continue; // Character has no key in this layout
+		}
+
+		held_keys[held_count++] = keycode;
+		if (dead) {
+			held_dead = true;
+			break;
+		}
+	}
+
+	if (held_count) {
+		add_weak_mods(mods);
+		for (uint8_t i = 0; i < held_count; i++) {
+			add_key(held_keys[i]);
+		}
+		send_keyboard_report();
+	}
+}
+
+static void release_keys(void) {
+	del_weak_mods(held_mods);
+
+	if (held_batch) {
+		for (uint8_t i = 0; i < held_count; i++) {
+			del_key(held_keys[i]);
+		}
+		send_keyboard_report();
+	} else {
+		unregister_code(held_keys[0]);
+	}
+
+	held_count = 0;
+	held_mods = 0;
+}
+
+// Ends the macro at once for a malformed opcode, rather than typing whatever follows it
+static uint32_t macro_exec_abort(const char *reason) {
+	dprintf("macro: %s, macro stopped\n", reason);
+	stats.cancelled++;
+	cursor = "";
+	depth = 0;
+	return 0;
+}
+
+// SS_DELAY is encoded as decimal digits followed by '|'
+static uint32_t read_delay(void) {
+	uint32_t ms = 0;
+
+	while (*cursor >= '0' && *cursor <= '9') {
+		ms = (ms * 10) + (*cursor++ - '0');
+	}
+	if (*cursor == '|') {
+		cursor++;
+	}
+	return ms;
+}
+
+// Interprets one token of the macro. Returns the number of milliseconds to wait before the next step.
+static uint32_t macro_exec_step(void) {
+	if (held_count) {
+		release_keys();
+
+		if (held_dead) {
+			// Dead keys need a space to produce the character on their own
+			held_dead = false;
+			press_key(KC_SPACE, 0);
+		}
+		return interval;
+	}
+
+	if (!*cursor) {
+		// End of a subroutine. Any loop left open inside it ends here too.
+		while (depth && !stack[depth - 1].call) {
+			depth--;
+		}
+		if (depth) {
+			cursor = stack[--depth].pos;
+		}
+		return 0;
+	}
+
+	if (*cursor == SS_QMK_PREFIX) {
+		cursor++;
+		char code = *cursor++;
+
+		switch (code) {
+			case SS_TAP_CODE:  press_key((uint8_t)*cursor++, 0); break;
+			case SS_DOWN_CODE: register_code((uint8_t)*cursor++); break;
+			case SS_UP_CODE:   unregister_code((uint8_t)*cursor++); break;
+			case SS_DELAY_CODE: return read_delay() + interval;
+
+			case SS_LOOP_CODE: {
+				uint8_t count = *cursor++ - '0';
+
+				if ((count < 1) || (count > 9)) {
+					return macro_exec_abort("bad loop count");
+				}
+				if (depth >= MACRO_STACK_DEPTH) {
+					return macro_exec_abort("loops nested too deep");
+				}
+				stack[depth++] = (macro_frame_t){ .pos = cursor, .remaining = count - 1, .call = false };
+				return 0;
+			}
+			case SS_END_CODE:
+				if (depth && !stack[depth - 1].call) {
+					if (stack[depth - 1].remaining) {
+						stack[depth - 1].remaining--;
+						cursor = stack[depth - 1].pos;
+					} else {
+						depth--;
+					}
+				}
+				return 0;
+
+			case SS_CALL_CODE: {
+#ifdef MACRO_SHARED_SEQUENCES
+				uint8_t index = *cursor++ - '0';
+
+				if (index >= SUB_COUNT) {
+					return macro_exec_abort("no such subroutine");
+				}
+				if (depth >= MACRO_STACK_DEPTH) {
+					return macro_exec_abort("calls nested too deep");
+				}
+				stack[depth++] = (macro_frame_t){ .pos = cursor, .remaining = 0, .call = true };
+				cursor = macro_subroutines[index];
+				return 0;
+#else
+				return macro_exec_abort("subroutines need MACRO_SHARED_SEQUENCES");
+#endif
+			}
+			case 0: cursor--; break; // Truncated prefix, let the next step end the macro
+			default: break;
+		}
+	} else {
+		press_chars();
+	}
+	return interval;
+}
+
+// ==========
+// = Player =
+// ==========
+static void macro_exec_begin(const macro_queue_entry_t *entry) {
+	uint32_t wait = timer_elapsed32(entry->time);
+
+	stats.started++;
+	stats.wait_total += wait;
+	if (wait > stats.wait_max) {
+		stats.wait_max = wait;
+	}
+
+	playing = entry->macro;
+	cursor = entry->macro;
+	interval = entry->interval;
+	depth = 0;
+}
+
+static bool queue_pop(macro_queue_entry_t *entry) {
+	if (!queue_count) {
+		return false;
+	}
+
+	*entry = queue[queue_head];
+	queue_head = (queue_head + 1) % MACRO_QUEUE_SIZE;
+	queue_count--;
+	return true;
+}
+
+static uint32_t macro_exec_task(void) {
+	for (uint8_t step = 0; step < MACRO_EXEC_STEPS; step++) {
+		if (!held_count && !*cursor && !depth) {
+			macro_queue_entry_t next;
+
+			if (queue_pop(&next)) {
+				// Keep the same task running for the next macro
+				macro_exec_begin(&next);
+				return 1;
+			}
+
+			playing = NULL;
+			cursor = NULL;
+			return 0;
+		}
+
+		uint32_t delay = macro_exec_step();
+		if (delay) {
+			return delay;
+		}
+	}
+	return 1; // Yield to the main loop even when no delay is requested
+}
+
+static sched_task_t macro_task = SCHED_TASK("Macro", SCHED_HID, macro_exec_task);
+
+// Stops the current macro, releasing any key it was holding
+static void macro_exec_halt(void) {
+	if (sched_active(&macro_task)) {
+		sched_stop(&macro_task);
+		stats.cancelled++;
+	}
+	if (held_count) {
+		held_dead = false;
+		release_keys();
+	}
+	playing = NULL;
+	cursor = NULL;
+	depth = 0;
+}
+
+// =========
+// = Queue =
+// =========
+bool macro_exec_queue(const char *macro, macro_policy_t policy, uint8_t delay) {
+	macro_queue_entry_t entry = { .macro = macro, .interval = delay, .time = timer_read32() };
+
+	switch (policy) {
+		case MQ_COALESCE:
+			// A press of a macro that is still playing or has not started yet would only repeat it
+			if (sched_active(&macro_task) && (playing == macro)) {
+				stats.coalesced++;
+				return true;
+			}
+			for (uint8_t i = 0; i < queue_count; i++) {
+				if (queue[(queue_head + i) % MACRO_QUEUE_SIZE].macro == macro) {
+					stats.coalesced++;
+					return true;
+				}
+			}
+			break;
+		case MQ_CANCEL:
+			macro_exec_stop();
+			break;
+		default: break;
+	}
+
+	if (!sched_active(&macro_task)) {
+		sched_start(&macro_task, 1);
+		macro_exec_begin(&entry);
+	} else if (queue_count < MACRO_QUEUE_SIZE) {
+		queue[(queue_head + queue_count) % MACRO_QUEUE_SIZE] = entry;
+		queue_count++;
+	} else {
+		stats.dropped++;
+		dprintf("macro: queue full, dropped press\n");
+		return false;
+	}
+
+	stats.queued++;
+	return true;
+}
+
+void macro_exec_stop(void) {
+	stats.cancelled += queue_count;
+	queue_count = 0;
+
+	macro_exec_halt();
+}
+
+bool macro_exec_busy(void) {
+	return sched_active(&macro_task);
+}
+
+const macro_queue_stats_t *macro_queue_stats(void) {
+	return &stats;
+}
@@ -0,0 +1,39 @@
+/* macro_executor.h
+ *
+ * Header file for the non-blocking SEND_STRING executor in keyboard firmware.
+ * Declares the queue policies and statistics, and functions to queue a macro, stop all macros and check whether one
+ * is still being typed.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+	MQ_QUEUE,    // Play after every macro already waiting
+	MQ_COALESCE, // Ignore the press if the same macro is already waiting
+	MQ_CANCEL,   // Stop the playing macro and discard the queue first
+} macro_policy_t;
+
+typedef struct {
+	uint16_t queued;     // Presses accepted, including ones that started immediately
+	uint16_t started;
+	uint16_t dropped;    // Presses lost because the queue was full
+	uint16_t coalesced;  // Presses merged into an identical waiting macro
+	uint16_t cancelled;  // Macros stopped or discarded before they finished
+	uint32_t wait_max;   // Longest time between a press and its macro starting, in ms
+	uint32_t wait_total; // Divide by started for the average wait
+} macro_queue_stats_t;
+
+// Sequences shared between macros through SS_CALL, indexed by the SUB_* numbers in send_string_macros.h. Only
+// needed when MACRO_SHARED_SEQUENCES is defined.
+extern const char *const macro_subroutines[];
+
+bool macro_exec_queue(const char *macro, macro_policy_t policy, uint8_t interval);
+void macro_exec_stop(void);
+bool macro_exec_busy(void);
+
+const macro_queue_stats_t *macro_queue_stats(void);
@@ -2,63 +2,95 @@
  *
  * Mostly adapted from https://getreuer.info/posts/keyboards/macros3/index.html
  * Defines a mouse jiggler function to prevent screen savers or sleep mode by simulating mouse movements.
- * Features two modes (fast and slow) to adjust the speed of the jiggling effect.
  *
- * Performs a slow movement by default, #define JIGGLE_FAST to use a faster movement.
+ * The jiggler stays dormant while the keyboard is in use and only wakes once nothing has been pressed for
+ * JIGGLE_IDLE_TIME. It then moves the mouse one step and back, which leaves the pointer where it was, and doubles the
+ * time to the next nudge up to JIGGLE_INTERVAL_MAX. Any activity puts it back to sleep and resets the interval.
  *
  * Requires the following features in rules.mk
- * DEFERRED_EXEC_ENABLE = yes
  * MOUSE_ENABLE = yes
  *
+ * Also requires task_scheduler.c, with sched_run called from housekeeping_task_user.
+ *
  * Author: Ryan Turner
  */
  
 #include "mouse_jiggler.h"
+#include "task_scheduler.h"
 #include "quantum.h"
 
-#ifdef JIGGLE_FAST
-	#define DELTAS_SIZE 32
-	static const int8_t deltas[32] = {
-		0,-1,-2,-2,-3,-3,-4,-4,-4,-4,-3,-3,-2,-2,-1, 0,
-		0, 1, 2, 2, 3, 3, 4, 4, 4, 4, 3, 3, 2, 2, 1, 0
-	};
-#else
-	#define DELTAS_SIZE 64
-	static const int8_t deltas[DELTAS_SIZE] = {
-		0, 0,-1,-1,-1,-2,-2,-2,-2,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-3,-2,-2,-2,-2,-1,-1,-1, 0, 0,
-		0, 0, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 0, 0
-	};
+#ifndef JIGGLE_IDLE_TIME
+#define JIGGLE_IDLE_TIME 30000 // No key activity for this long before the first nudge, in ms
+#endif
+
+#ifndef JIGGLE_INTERVAL_MIN
+#define JIGGLE_INTERVAL_MIN 5000
+#endif
+
+#ifndef JIGGLE_INTERVAL_MAX
+#define JIGGLE_INTERVAL_MAX 60000
 #endif
 
-static deferred_token token = INVALID_DEFERRED_TOKEN;
+#define JIGGLE_RETURN_TIME 16 // Time between the step out and the step back, in ms
+
 static report_mouse_t report = {0};
+static uint32_t interval = JIGGLE_INTERVAL_MIN;
+static uint32_t reports_sent = 0;
 
-void jiggle_start(void) {
-	uint32_t jiggler_callback(uint32_t trigger_time, void* cb_arg) {
-		static uint8_t phase = 0;
-		
-		report.x = deltas[phase];
-		report.y = deltas[(phase + (DELTAS_SIZE / 4)) & (DELTAS_SIZE - 1)];
-		
+static uint32_t jiggler_task(void) {
+	// The step back is always sent, even if a key was pressed in between
+	if (report.x) {
+		report.x = -report.x;
 		host_mouse_send(&report);
-		
-		phase = (phase + 1) & (DELTAS_SIZE - 1);
-		
-		return 16; // Callback in 16ms/60fps
+		report.x = 0;
+		reports_sent++;
+
+		// Wait the current interval, then back off for the nudge after
+		uint32_t wait = interval;
+		interval = (interval < JIGGLE_INTERVAL_MAX / 2) ? interval * 2 : JIGGLE_INTERVAL_MAX;
+		return wait;
+	}
+
+	uint32_t idle = last_input_activity_elapsed();
+
+	if (idle < JIGGLE_IDLE_TIME) {
+		interval = JIGGLE_INTERVAL_MIN;
+		return JIGGLE_IDLE_TIME - idle;
 	}
-	
-	token = defer_exec(1, jiggler_callback, NULL);
+
+	report.x = 1;
+	host_mouse_send(&report);
+	reports_sent++;
+
+	return JIGGLE_RETURN_TIME;
+}
+
+static sched_task_t jiggle = SCHED_TASK("Jiggle", SCHED_HID, jiggler_task);
+
+void jiggle_start(void) {
+	interval = JIGGLE_INTERVAL_MIN;
+	sched_start(&jiggle, JIGGLE_IDLE_TIME);
 }
 
 void jiggle_stop(void) {
-	if (token) {
-		cancel_deferred_exec(token);
-		token = INVALID_DEFERRED_TOKEN;
+	if (sched_active(&jiggle)) {
+		sched_stop(&jiggle);
+
+		// Finish a nudge that is waiting for its step back so the pointer ends where it started
+		if (report.x) {
+			report.x = -report.x;
+			host_mouse_send(&report);
+			reports_sent++;
+		}
 		report = (report_mouse_t){}; // Clear mouse
 		host_mouse_send(&report);
 	}
 }
 
 bool jiggle_state(void) {
-	return token;
+	return sched_active(&jiggle);
+}
+
+uint32_t jiggle_reports_sent(void) {
+	return reports_sent;
 }
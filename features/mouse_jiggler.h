@@ -2,6 +2,7 @@
  *
  * Header file for the mouse jiggler functionality in keyboard firmware.
  * Declares functions for controlling the mouse jiggler, allowing other firmware parts to start or stop jiggling and check its current state.
+ * Also reports how many mouse reports the jiggler has sent.
  *
  * Author: Ryan Turner
  */
@@ -9,7 +10,9 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 void jiggle_start(void);
 void jiggle_stop(void);
 bool jiggle_state(void);
+uint32_t jiggle_reports_sent(void);
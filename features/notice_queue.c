@@ -0,0 +1,125 @@
+/* notice_queue.c
+ *
+ * A fixed number of notices waiting to be shown, each with a priority, a duration and two lines of text that are
+ * formatted once when it is queued. The notice shown is always the highest priority one that is waiting, oldest
+ * first, and its time starts running the first time it is shown. A notice that is preempted by a more important one
+ * keeps counting down, so it only gets whatever time it has left once that one is done. When notice_current has
+ * not been called for a while, because the display was off, notices that were never shown and are older than their
+ * duration are stale and are dropped rather than shown late.
+ *
+ * A notice with the same title as one already waiting replaces its text in place instead of taking another slot, so
+ * toggling a feature twice shows its final state rather than both. When every slot is full the notice that would be
+ * shown last is dropped, and with equal priorities that is the new one.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "notice_queue.h"
+#include "quantum.h"
+
+static notice_t notices[NOTICE_QUEUE_LEN];
+#ifndef NOTICE_POLL_GAP
+#define NOTICE_POLL_GAP 500 // A gap this long between calls to notice_current means the display was off, in ms
+#endif
+
+static uint32_t next_order = 0;
+static uint32_t last_poll = 0;
+static uint16_t dropped = 0;
+
+static void set_lines(notice_t *notice, const char *title, const char *text) {
+	strncpy(notice->lines[0], title, NOTICE_LEN - 1);
+	strncpy(notice->lines[1], text, NOTICE_LEN - 1);
+	notice->lines[0][NOTICE_LEN - 1] = '\0';
+	notice->lines[1][NOTICE_LEN - 1] = '\0';
+	notice->version++;
+}
+
+// True when a should be shown before b
+static bool ahead_of(const notice_t *a, const notice_t *b) {
+	return (a->priority != b->priority) ? (a->priority > b->priority) : (a->order < b->order);
+}
+
+bool notice_push(notice_priority_t priority, uint16_t duration, const char *title, const char *text) {
+	notice_t *slot = NULL;
+
+	for (uint8_t i = 0; i < NOTICE_QUEUE_LEN; i++) {
+		if (notices[i].used && !strncmp(notices[i].lines[0], title, NOTICE_LEN - 1)) {
+			// Start its time again, since the text has changed
+			notices[i].shown = false;
+			notices[i].duration = duration;
+			notices[i].pushed_at = timer_read32();
+			if (priority > notices[i].priority) {
+				notices[i].priority = priority;
+			}
+			set_lines(&notices[i], title, text);
+			return true;
+		}
+		if (!notices[i].used) {
+			slot = &notices[i];
+		}
+	}
+
+	if (!slot) {
+		slot = &notices[0];
+		for (uint8_t i = 1; i < NOTICE_QUEUE_LEN; i++) {
+			if (ahead_of(slot, &notices[i])) {
+				slot = &notices[i];
+			}
+		}
+		dropped++;
+
+		if (slot->priority >= priority) {
+			return false;
+		}
+	}
+
+	slot->used = true;
+	slot->shown = false;
+	slot->priority = priority;
+	slot->duration = duration;
+	slot->order = next_order++;
+	slot->pushed_at = timer_read32();
+	set_lines(slot, title, text);
+	return true;
+}
+
+// Call once per frame, retires expired notices and returns the one to show, or NULL when there is nothing to show
+const notice_t *notice_current(void) {
+	notice_t *best = NULL;
+	bool      resumed = timer_elapsed32(last_poll) > NOTICE_POLL_GAP;
+
+	last_poll = timer_read32();
+
+	for (uint8_t i = 0; i < NOTICE_QUEUE_LEN; i++) {
+		notice_t *notice = &notices[i];
+
+		if (!notice->used) {
+			continue;
+		}
+		if (notice->shown ? (timer_elapsed(notice->shown_at) >= notice->duration)
+		                  : (resumed && (timer_elapsed32(notice->pushed_at) >= notice->duration))) {
+			notice->used = false;
+			continue;
+		}
+		if (!best || ahead_of(notice, best)) {
+			best = notice;
+		}
+	}
+
+	if (best && !best->shown) {
+		best->shown = true;
+		best->shown_at = timer_read();
+	}
+	return best;
+}
+
+void notice_clear(void) {
+	for (uint8_t i = 0; i < NOTICE_QUEUE_LEN; i++) {
+		notices[i].used = false;
+	}
+}
+
+// Notices lost because the queue was full of more important ones
+uint16_t notice_dropped(void) {
+	return dropped;
+}
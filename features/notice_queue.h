@@ -0,0 +1,44 @@
+/* notice_queue.h
+ *
+ * Header file for the queue of short notices shown on the OLED in keyboard firmware.
+ * Declares the notice format and priorities, and functions to queue a notice and find the one to show now.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef NOTICE_QUEUE_LEN
+#define NOTICE_QUEUE_LEN 4
+#endif
+
+// Rows of text in a notice and the most characters in each, including the terminator. Lines are kept to 20
+// characters so they never fill a row and wrap onto the next one.
+#define NOTICE_LINES 2
+#define NOTICE_LEN   21
+
+typedef enum {
+	NOTICE_LOW,    // Frequent and unimportant, such as macros being sent
+	NOTICE_NORMAL,
+	NOTICE_HIGH,   // Shown ahead of anything else that is waiting
+} notice_priority_t;
+
+typedef struct {
+	char     lines[NOTICE_LINES][NOTICE_LEN];
+	uint16_t duration;  // How long to show it for once it is first shown, in ms
+	uint16_t shown_at;
+	uint32_t pushed_at; // Never shown notices are stale once this is duration old and the display was off
+	uint8_t  priority;
+	uint8_t  version;   // Changes whenever the lines are replaced, so a drawn copy can be checked without comparing text
+	bool     used;
+	bool     shown;
+	uint32_t order;     // Queue order within a priority
+} notice_t;
+
+bool notice_push(notice_priority_t priority, uint16_t duration, const char *title, const char *text);
+const notice_t *notice_current(void);
+void notice_clear(void);
+uint16_t notice_dropped(void);
@@ -0,0 +1,190 @@
+/* particles.c
+ *
+ * Procedural rain, snow and sparks for the OLED. Particles live in a fixed pool and unused ones are chained into a
+ * free list, so spawning and retiring a particle is a single link change and nothing is ever allocated. Positions
+ * and velocities are fixed point with PARTICLE_FP steps per pixel. Changing style clears the pool.
+ *
+ * Every update moves each live particle and links it into a list for the page it is now on. The page lists are
+ * drawn by particles_draw_page, which bitmaps.c calls for each page as an overlay, so particles are ORed straight
+ * into the page layout framebuffer over whatever the renderer drew.
+ *
+ * Call particles_update once per frame with a spawn rate, then render_overlay(particles_draw_page) before drawing
+ * the background.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "particles.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define PARTICLE_NONE 0xFF
+#define PARTICLE_X_WRAP ((128 * PARTICLE_FP) - 1) // Columns wrap around, x is always kept in range with this mask
+#define PARTICLE_Y_MAX  (64 * PARTICLE_FP)
+
+#define SPARK_GRAVITY 3 // Added to a spark's downward velocity every frame
+#define SPARK_LIFE    48
+
+typedef struct {
+	uint16_t x;
+	int16_t  y;
+	int8_t   dx;   // Velocity per frame
+	int8_t   dy;
+	uint8_t  life; // Frames left, only counted down for sparks
+	uint8_t  next; // Next particle on the same page, or in the free list
+} particle_t;
+
+static particle_t pool[PARTICLE_COUNT];
+static uint8_t page_head[8];
+static uint8_t free_head = PARTICLE_NONE;
+static uint8_t live = 0;
+static uint16_t spawn_fp = 0;
+static bool ready = false;
+static particle_style_t last_style;
+
+static uint16_t rng_state = 0xACE1;
+
+// 16 bit xorshift, plenty random for weather
+static uint16_t rng(void) {
+	rng_state ^= rng_state << 7;
+	rng_state ^= rng_state >> 9;
+	rng_state ^= rng_state << 8;
+	return rng_state;
+}
+
+void particles_clear(void) {
+	for (uint8_t i = 0; i < PARTICLE_COUNT; i++) {
+		pool[i].next = (i + 1 < PARTICLE_COUNT) ? i + 1 : PARTICLE_NONE;
+	}
+	memset(page_head, PARTICLE_NONE, sizeof(page_head));
+	free_head = 0;
+	live = 0;
+	spawn_fp = 0;
+	ready = true;
+}
+
+uint8_t particles_live(void) {
+	return live;
+}
+
+static void spawn(particle_t *p, particle_style_t style) {
+	uint16_t r = rng();
+
+	p->x = (r & PARTICLE_X_WRAP);
+	p->life = SPARK_LIFE;
+
+	switch (style) {
+		case PARTICLE_RAIN:
+			p->y = 0;
+			p->dx = -8;
+			p->dy = 80 + (r >> 11);
+			break;
+
+		case PARTICLE_SNOW:
+			p->y = 0;
+			p->dx = (int8_t)((r >> 13) & 3) - 2;
+			p->dy = 6 + ((r >> 10) & 7);
+			break;
+
+		case PARTICLE_SPARKS:
+			p->y = PARTICLE_Y_MAX - 1;
+			p->dx = (int8_t)(r >> 8) / 4;
+			p->dy = -64 - ((r >> 10) & 31);
+			break;
+	}
+}
+
+// Returns false once the particle has left the screen or burnt out and should go back to the free list
+static bool step(particle_t *p, particle_style_t style) {
+	if (style == PARTICLE_SNOW) {
+		// Flakes wander by a step now and then
+		uint16_t r = rng();
+		if ((r & 7) == 0) {
+			p->dx += ((r & 8) && (p->dx < 4)) ? 1 : (p->dx > -4) ? -1 : 0;
+		}
+	} else if (style == PARTICLE_SPARKS) {
+		if (!--p->life) {
+			return false;
+		}
+		p->dy = (p->dy > 127 - SPARK_GRAVITY) ? 127 : p->dy + SPARK_GRAVITY;
+	}
+
+	p->x = (p->x + p->dx) & PARTICLE_X_WRAP;
+	p->y += p->dy;
+
+	return (p->y >= 0) && (p->y < PARTICLE_Y_MAX);
+}
+
+/* Every live particle is on exactly one page list, so walking them all visits the whole live set. Each one is moved
+ * and relinked onto its new page, or returned to the free list. Spawn_rate is new particles per frame in 1/PARTICLE_FP.
+ */
+void particles_update(particle_style_t style, uint16_t spawn_rate) {
+	// A new style starts from an empty screen rather than moving the old particles by the new rules
+	if (!ready || (style != last_style)) {
+		particles_clear();
+		last_style = style;
+	}
+
+	uint8_t heads[8];
+	memset(heads, PARTICLE_NONE, sizeof(heads));
+
+	for (uint8_t page = 0; page < 8; page++) {
+		uint8_t i = page_head[page];
+
+		while (i != PARTICLE_NONE) {
+			particle_t *p = &pool[i];
+			uint8_t next = p->next;
+
+			if (step(p, style)) {
+				uint8_t to = p->y / (8 * PARTICLE_FP);
+				p->next = heads[to];
+				heads[to] = i;
+			} else {
+				p->next = free_head;
+				free_head = i;
+				live--;
+			}
+			i = next;
+		}
+	}
+
+	spawn_fp += spawn_rate;
+
+	while ((spawn_fp >= PARTICLE_FP) && (free_head != PARTICLE_NONE)) {
+		uint8_t i = free_head;
+		particle_t *p = &pool[i];
+
+		spawn_fp -= PARTICLE_FP;
+		free_head = p->next;
+		live++;
+
+		spawn(p, style);
+		uint8_t to = p->y / (8 * PARTICLE_FP);
+		p->next = heads[to];
+		heads[to] = i;
+	}
+
+	// Don't bank spawns while the pool is full, or it would empty and refill in bursts
+	if (spawn_fp >= PARTICLE_FP) {
+		spawn_fp = 0;
+	}
+
+	memcpy(page_head, heads, sizeof(heads));
+}
+
+// Rain is drawn as a two pixel streak, clipped to the page so that the page lists stay exact
+void particles_draw_page(uint8_t page, char *out) {
+	if (!ready) {
+		return;
+	}
+	for (uint8_t i = page_head[page]; i != PARTICLE_NONE; i = pool[i].next) {
+		const particle_t *p = &pool[i];
+		uint8_t row = (p->y / PARTICLE_FP) & 7;
+		uint8_t bits = 1 << row;
+
+		if ((p->dy > 127 / 2) && row) {
+			bits |= bits >> 1;
+		}
+		out[p->x / PARTICLE_FP] |= bits;
+	}
+}
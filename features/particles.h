@@ -0,0 +1,30 @@
+/* particles.h
+ *
+ * Header file for the OLED particle effects in keyboard firmware.
+ * Declares the particle styles and functions to step the simulation and draw it over a frame from bitmaps.c.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Size of the particle pool, at most 255
+#ifndef PARTICLE_COUNT
+#define PARTICLE_COUNT 192
+#endif
+
+// Positions and velocities are in 1/PARTICLE_FP of a pixel
+#define PARTICLE_FP 32
+
+typedef enum {
+	PARTICLE_RAIN,   // Fast streaks falling at a slant
+	PARTICLE_SNOW,   // Slow flakes drifting from side to side
+	PARTICLE_SPARKS, // Thrown up from the bottom and pulled back down
+} particle_style_t;
+
+void particles_update(particle_style_t style, uint16_t spawn_rate);
+void particles_draw_page(uint8_t page, char *out);
+void particles_clear(void);
+uint8_t particles_live(void);
@@ -0,0 +1,115 @@
+/* scan_profiler.c
+ *
+ * Measures the time between matrix scans to find what makes keys late. Every interval goes into a histogram, and
+ * the longest one is held for SCAN_HOLD_TIME so short spikes can still be read off the OLED. An interval of
+ * SCAN_STALL_TIME or more counts as a stall and is blamed on whichever marked feature ran longest since the last scan.
+ *
+ * Features mark their work with scan_profiler_begin and scan_profiler_end. Marks do not nest, the scheduler marks
+ * each task with its name and tap dances and select word mark their key handling. A mark that is not ended runs until
+ * the next mark or scan, which is how oled_task_user marks the I2C flush that QMK does after it returns.
+ *
+ * Intervals are measured with the 1 ms system timer, so the histogram uses 1 ms buckets, which is as fine as the
+ * timer can tell apart.
+ *
+ * Call scan_profiler_task from matrix_scan_user.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "scan_profiler.h"
+#include "quantum.h"
+
+#ifndef SCAN_STALL_TIME
+#define SCAN_STALL_TIME 5 // Scan intervals this long or longer are stalls, in ms
+#endif
+
+#ifndef SCAN_HOLD_TIME
+#define SCAN_HOLD_TIME 5000 // How long the peak interval is held, in ms
+#endif
+
+static scan_stats_t stats = {.interval = HIST_INIT(1)};
+
+static uint32_t last_scan = 0;
+static uint32_t hold_time = 0;
+
+// The marked feature that ran longest since the last scan
+static const char *segment_tag = NULL;
+static uint32_t    segment_start = 0;
+static const char *longest_tag = NULL;
+static uint16_t    longest_time = 0;
+
+void scan_profiler_begin(const char *tag) {
+	if (segment_tag) {
+		scan_profiler_end();
+	}
+	segment_tag = tag;
+	segment_start = timer_read32();
+}
+
+void scan_profiler_end(void) {
+	uint32_t elapsed = timer_elapsed32(segment_start);
+
+	if (segment_tag && (!longest_tag || (elapsed > longest_time))) {
+		longest_tag = segment_tag;
+		longest_time = (elapsed < UINT16_MAX) ? elapsed : UINT16_MAX;
+	}
+	segment_tag = NULL;
+}
+
+static void record_stall(uint16_t interval) {
+	const char *tag = (longest_tag && longest_time) ? longest_tag : "Other";
+	scan_stall_t *slot = NULL;
+
+	for (uint8_t i = 0; i < SCAN_STALL_TAGS; i++) {
+		if ((stats.stall[i].tag == tag) || !stats.stall[i].tag) {
+			slot = &stats.stall[i];
+			break;
+		}
+	}
+	if (!slot) {
+		return; // Every slot belongs to another feature, the stall still counts towards the total
+	}
+
+	slot->tag = tag;
+	if (slot->count < UINT16_MAX) {
+		slot->count++;
+	}
+	if (interval > slot->worst) {
+		slot->worst = interval;
+	}
+}
+
+void scan_profiler_task(void) {
+	if (segment_tag) {
+		scan_profiler_end();
+	}
+
+	uint32_t now = timer_read32();
+	uint32_t elapsed = TIMER_DIFF_32(now, last_scan);
+	uint16_t interval = (elapsed < UINT16_MAX) ? elapsed : UINT16_MAX;
+
+	// The first scan has nothing to compare against
+	if (last_scan) {
+		hist_add(&stats.interval, interval);
+
+		if ((interval >= stats.hold) || (TIMER_DIFF_32(now, hold_time) >= SCAN_HOLD_TIME)) {
+			stats.hold = interval;
+			hold_time = now;
+		}
+
+		if (interval >= SCAN_STALL_TIME) {
+			if (stats.stalls < UINT16_MAX) {
+				stats.stalls++;
+			}
+			record_stall(interval);
+		}
+	}
+
+	last_scan = now;
+	longest_tag = NULL;
+	longest_time = 0;
+}
+
+const scan_stats_t *scan_profiler_stats(void) {
+	return &stats;
+}
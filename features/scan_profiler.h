@@ -0,0 +1,37 @@
+/* scan_profiler.h
+ *
+ * Header file for the matrix scan stall profiler in keyboard firmware.
+ * Declares the scan interval statistics, the per feature stall counts and functions to mark the code a feature runs
+ * so that long scans can be blamed on it.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "histogram.h"
+
+#ifndef SCAN_STALL_TAGS
+#define SCAN_STALL_TAGS 8 // Distinct features that stalls are counted for
+#endif
+
+typedef struct {
+	const char *tag;   // Name passed to scan_profiler_begin, or "Other" when no marked code ran long
+	uint16_t    count;
+	uint16_t    worst; // Longest stalled scan interval, in ms
+} scan_stall_t;
+
+typedef struct {
+	hist_t       interval; // Time between matrix scans, in ms
+	uint16_t     hold;     // Longest interval in the last SCAN_HOLD_TIME
+	uint16_t     stalls;
+	scan_stall_t stall[SCAN_STALL_TAGS];
+} scan_stats_t;
+
+void scan_profiler_task(void);
+void scan_profiler_begin(const char *tag);
+void scan_profiler_end(void);
+
+const scan_stats_t *scan_profiler_stats(void);
@@ -3,25 +3,63 @@
  * Defines macros for enhanced string sending and key repetition in keyboard firmware scripts.
  * Simplifies the creation of complex macros, such as opening web pages or repeating key sequences.
  *
+ * REPT and SS_CALL build compact opcodes that are only understood by macro_executor, not by send_string. Repeats are
+ * looped at runtime, and with MACRO_SHARED_SEQUENCES the sequences used by many macros are written once as
+ * subroutines and called, which keeps the strings in macro_info much shorter.
+ *
  * Author: Ryan Turner
  */
 
 
 #pragma once
 
+// Opcodes that follow SS_QMK_PREFIX, continuing from QMK's SS_TAP_CODE to SS_DELAY_CODE
+#define SS_LOOP_CODE 5
+#define SS_END_CODE  6
+#define SS_CALL_CODE 7
+
+#define SS_STR(x) SS_STR_(x)
+#define SS_STR_(x) #x
+
+// Play subroutine n from macro_subroutines, n is sent as a single digit and checked against SUB_COUNT when played
+#define SS_CALL(n) "\1\7" SS_STR(n)
+
+// Subroutines, the keymap fills macro_subroutines using the matching SUB_*_SEQ
+#define SUB_START  0
+#define SUB_LAUNCH 1
+#define SUB_BROWSE 2
+#define SUB_COUNT  3
+
+#define SUB_START_SEQ  SS_TAP(X_LGUI) SS_DELAY(200)
+#define SUB_LAUNCH_SEQ SS_DELAY(200) "\n" SS_DELAY(650)
+#define SUB_BROWSE_SEQ SS_TAP(X_WWW_HOME) SS_DELAY(300) SS_LCTL("l")
+
 // Open a web address in a new tab
 #define SS_WEB(s) SS_LCTL("t") s SS_LCTL("\n")
 
+/* The shared sequences only save flash once two or more macros use them, since the table costs more than a single
+ * use saves. Define MACRO_SHARED_SEQUENCES in config.h to play them as subroutines, otherwise they are inlined.
+ */
+#ifdef MACRO_SHARED_SEQUENCES
 // Opens a web address after X_WWW_HOME
-#define SS_BROWSE(s) SS_TAP(X_WWW_HOME) SS_DELAY(300) SS_LCTL("l") s SS_LCTL("\n")
+#define SS_BROWSE(s) SS_CALL(SUB_BROWSE) s SS_LCTL("\n")
 
 // Opens a program by searching it in the start menu
-# define SS_START(s) SS_TAP(X_LGUI) SS_DELAY(200) s SS_DELAY(200) "\n" SS_DELAY(650)
-
-// Repeat the passed string n times
-#define REPT(s, n) REPT_S##n(s)
-#define REPT_S1(s) s
-#define REPT_S2(s) s s
-#define REPT_S3(s) s s s
-#define REPT_S4(s) s s s s
-#define REPT_S5(s) s s s s s
+# define SS_START(s) SS_CALL(SUB_START) s SS_CALL(SUB_LAUNCH)
+#else
+#define SS_BROWSE(s) SUB_BROWSE_SEQ s SS_LCTL("\n")
+# define SS_START(s) SUB_START_SEQ s SUB_LAUNCH_SEQ
+#endif
+
+// Repeat the passed string n times, where n is between 1 and 9. Any other count is an undefined REPT_COUNT_ error.
+#define REPT(s, n) "\1\5" REPT_COUNT_##n s "\1\6"
+
+#define REPT_COUNT_1 "1"
+#define REPT_COUNT_2 "2"
+#define REPT_COUNT_3 "3"
+#define REPT_COUNT_4 "4"
+#define REPT_COUNT_5 "5"
+#define REPT_COUNT_6 "6"
+#define REPT_COUNT_7 "7"
+#define REPT_COUNT_8 "8"
+#define REPT_COUNT_9 "9"
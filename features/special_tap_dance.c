@@ -8,11 +8,108 @@
  *
  * I also recommend #define PERMISSIVE_HOLD in config.h
  *
+ * Each dance also keeps statistics on how long it takes to decide and what it decides, so tapping terms can be tuned
+ * from real numbers. These are read with tap_dance_stats or printed with tap_dance_stats_dump.
+ *
+ * Only a small part of QMK is used here, so this file is also built on a host against stubs of tap_dance_state_t,
+ * tap_dance_actions, timer_read/timer_elapsed, register_code16/unregister_code16/tap_code16, layer_on/layer_off/
+ * layer_invert and uprintf. test/tap_dance_test.c replays press and release timelines through it, run make -C test.
+ *
  * Author: Ryan Turner
  */
 
 #include "special_tap_dance.h"
 #include "quantum.h"
+#include <stddef.h>
+#include "scan_profiler.h"
+#include "key_latency.h"
+
+// Marks the callbacks that send reports or change layers, so slow scans can be blamed on tap dances
+static const char profile_tag[] = "TapDance";
+
+// =======================
+// = Decision Statistics =
+// =======================
+// Latency and outcome counters for each dance, see tap_dance_stats_dump for reading them over the console
+static td_stats_t stats[TD_STATS_KEYS] = {[0 ... TD_STATS_KEYS - 1] = {.wait = HIST_INIT(TD_STATS_BUCKET)}};
+static uint16_t   first_press[TD_STATS_KEYS];
+static bool       deciding[TD_STATS_KEYS];
+
+static uint8_t  last_resolved = UINT8_MAX;
+static uint16_t last_resolved_time = 0;
+static bool     correction_armed = false;
+
+// Callbacks only get the dance's state, which lives inside its entry in tap_dance_actions
+static uint8_t dance_index(tap_dance_state_t *state) {
+	return (tap_dance_action_t *)((char *)state - offsetof(tap_dance_action_t, state)) - tap_dance_actions;
+}
+
+// Called just before the outcome's report is sent, so that key_latency can time it from the first press
+static void record_outcome(tap_dance_state_t *state, td_state_t outcome, key_path_t path) {
+	uint8_t index = dance_index(state);
+
+	if ((index >= TD_STATS_KEYS) || (outcome == TD_NONE)) {
+		return;
+	}
+	if (deciding[index]) {
+		hist_add(&stats[index].wait, timer_elapsed(first_press[index]));
+		key_latency_arm(path, first_press[index]);
+		deciding[index] = false;
+	}
+	stats[index].outcomes[outcome - 1]++;
+
+	last_resolved = index;
+	last_resolved_time = timer_read();
+	correction_armed = true;
+}
+
+void process_tap_dance_stats(uint16_t keycode, keyrecord_t *record, uint16_t backspace) {
+	if (!record->event.pressed) {
+		return;
+	}
+
+	// Only the first key after a dance can correct it, and a backspace dance deleting more is not a correction
+	if (correction_armed && ((keycode == KC_BSPC) || (keycode == backspace)) && (keycode != TD(last_resolved)) &&
+			(timer_elapsed(last_resolved_time) <= TD_CORRECTION_TIME)) {
+		stats[last_resolved].corrections++;
+	}
+	correction_armed = false;
+
+	if (IS_QK_TAP_DANCE(keycode) && (QK_TAP_DANCE_GET_INDEX(keycode) < TD_STATS_KEYS)) {
+		uint8_t index = QK_TAP_DANCE_GET_INDEX(keycode);
+
+		// A dance keeps deciding across several presses until it commits an action
+		if (!deciding[index]) {
+			first_press[index] = record->event.time;
+			deciding[index] = true;
+		}
+	}
+}
+
+const td_stats_t *tap_dance_stats(uint8_t index) {
+	return (index < TD_STATS_KEYS) ? &stats[index] : NULL;
+}
+
+// Index of the most recently resolved dance, or UINT8_MAX before any dance has resolved
+uint8_t tap_dance_stats_last(void) {
+	return last_resolved;
+}
+
+// Needs CONSOLE_ENABLE = yes in rules.mk and qmk console on the host
+void tap_dance_stats_dump(void) {
+	uprintf("TD  count  avg  p50  p90  max  fix  1T/1H/2T/2H/MT/MH/2P\n");
+	for (uint8_t i = 0; i < TD_STATS_KEYS; i++) {
+		td_stats_t *s = &stats[i];
+
+		if (!s->wait.count) {
+			continue;
+		}
+		uprintf("%2u %6u %4u %4u %4u %4u %4u  %u/%u/%u/%u/%u/%u/%u\n", i, s->wait.count, hist_mean(&s->wait),
+			hist_percentile(&s->wait, 50), hist_percentile(&s->wait, 90), s->wait.max, s->corrections,
+			s->outcomes[0], s->outcomes[1], s->outcomes[2], s->outcomes[3], s->outcomes[4], s->outcomes[5],
+			s->outcomes[6]);
+	}
+}
 
 // ============
 // = Tap Hold =
@@ -22,7 +119,10 @@ void tap_dance_tap_hold_on_each_release(tap_dance_state_t *state, void *user_dat
 	tap_dance_tap_hold_t *tap_hold = (tap_dance_tap_hold_t *)user_data;
 	
 	if (state->count && !state->finished) {
+		record_outcome(state, TD_SINGLE_TAP, KL_TAP_HOLD);
+		scan_profiler_begin(profile_tag);
 		tap_code16(tap_hold->tap);
+		scan_profiler_end();
 	}
 }
 
@@ -30,6 +130,8 @@ void tap_dance_tap_hold_finished(tap_dance_state_t *state, void *user_data) {
     tap_dance_tap_hold_t *tap_hold = (tap_dance_tap_hold_t *)user_data;
 
     if (state->pressed) {
+        record_outcome(state, (state->count == 1) ? TD_SINGLE_HOLD : TD_DOUBLE_HOLD, KL_TAP_HOLD);
+        scan_profiler_begin(profile_tag);
         if (state->count == 1) {
             register_code16(tap_hold->hold);
             tap_hold->held = tap_hold->hold;
@@ -37,6 +139,7 @@ void tap_dance_tap_hold_finished(tap_dance_state_t *state, void *user_data) {
             register_code16(tap_hold->tap);
             tap_hold->held = tap_hold->tap;
         }
+        scan_profiler_end();
     }
 }
 
@@ -44,7 +147,9 @@ void tap_dance_tap_hold_reset(tap_dance_state_t *state, void *user_data) {
     tap_dance_tap_hold_t *tap_hold = (tap_dance_tap_hold_t *)user_data;
 
     if (tap_hold->held) {
+        scan_profiler_begin(profile_tag);
         unregister_code16(tap_hold->held);
+        scan_profiler_end();
         tap_hold->held = 0;
     }
 }
@@ -52,19 +157,8 @@ void tap_dance_tap_hold_reset(tap_dance_state_t *state, void *user_data) {
 // ==================
 // = Quad Tap Dance =
 // ==================
-// Definitions and handling for up to four different actions based on tap count and press state
-typedef enum {
-    TD_NONE,
-    TD_SINGLE_TAP,
-    TD_SINGLE_HOLD,
-    TD_DOUBLE_TAP,
-	TD_DOUBLE_HOLD,
-	TD_MULTI_TAP,
-	TD_MULTI_HOLD,
-} td_state_t;
-
-static td_state_t td_state;
-
+// Definitions and handling for up to four different actions based on tap count and press state.
+// The resolved state is kept in each dance's tap_dance_quad_t so that overlapping dances do not share it.
 td_state_t cur_dance(tap_dance_state_t  *state) {
     if (state->count == 1) {
 		if (!state->pressed) {
@@ -88,6 +182,7 @@ td_state_t cur_dance(tap_dance_state_t  *state) {
 }
 
 void finish_action(uint16_t kc_or_layer, tap_dance_mode_t mode) {
+	scan_profiler_begin(profile_tag);
 	switch (mode) {
 		case TDM_KC:
 			register_code16(kc_or_layer);
@@ -100,13 +195,59 @@ void finish_action(uint16_t kc_or_layer, tap_dance_mode_t mode) {
 			break;
 		default: break;
 	}
+	scan_profiler_end();
+}
+
+#define TD_EARLY_CHECKED 1 // Flags below have been worked out
+#define TD_EARLY_RELEASE 2 // No double action, a single tap is final on release
+#define TD_EARLY_SECOND  4 // Double hold is absent or the same as double tap, a double is final on the second press
+
+static uint8_t early_flags(tap_dance_quad_t *quad) {
+	uint8_t flags = TD_EARLY_CHECKED;
+
+#ifndef NO_TAP_DANCE_EARLY_COMMIT
+	if ((quad->double_tap_action == TDM_NO) && (quad->double_hold_action == TDM_NO)) {
+		flags |= TD_EARLY_RELEASE;
+	} else if ((quad->double_tap_action != TDM_NO) && ((quad->double_hold_action == TDM_NO) ||
+			((quad->double_hold == quad->double_tap) && (quad->double_hold_action == quad->double_tap_action)))) {
+		flags |= TD_EARLY_SECOND;
+	}
+#endif
+	return flags;
+}
+
+void tap_dance_quad_on_each_tap(tap_dance_state_t *state, void *user_data) {
+	tap_dance_quad_t *quad = (tap_dance_quad_t *)user_data;
+
+	if (!quad->early) {
+		quad->early = early_flags(quad);
+	}
+
+	// Marking the dance finished makes QMK skip the finished callback and reset on this release
+	if ((state->count == 2) && (quad->early & TD_EARLY_SECOND)) {
+		quad->state = TD_DOUBLE_PRESS;
+		record_outcome(state, quad->state, KL_QUAD);
+		finish_action(quad->double_tap, quad->double_tap_action);
+		state->finished = true;
+	}
+}
+
+void tap_dance_quad_on_each_release(tap_dance_state_t *state, void *user_data) {
+	tap_dance_quad_t *quad = (tap_dance_quad_t *)user_data;
+
+	if ((state->count == 1) && !state->finished && (quad->early & TD_EARLY_RELEASE)) {
+		quad->state = TD_SINGLE_TAP;
+		state->finished = true;
+		record_outcome(state, quad->state, KL_QUAD);
+	}
 }
 
 void tap_dance_quad_finished(tap_dance_state_t *state, void *user_data) {
 	tap_dance_quad_t *quad = (tap_dance_quad_t *)user_data;
-	td_state = cur_dance(state);
+	quad->state = cur_dance(state);
+	record_outcome(state, quad->state, KL_QUAD);
 	
-    switch (td_state) {
+    switch (quad->state) {
         case TD_SINGLE_HOLD:
 			finish_action(quad->single_hold, quad->single_hold_action);
 			break;
@@ -117,7 +258,8 @@ void tap_dance_quad_finished(tap_dance_state_t *state, void *user_data) {
     }
 }
 
-void reset_action(uint16_t kc_or_layer, tap_dance_mode_t mode) {
+void reset_action(uint16_t kc_or_layer, tap_dance_mode_t mode, td_state_t td_state) {
+	scan_profiler_begin(profile_tag);
 	switch (mode) {
 		case TDM_KC:
 			switch (td_state) {
@@ -125,6 +267,7 @@ void reset_action(uint16_t kc_or_layer, tap_dance_mode_t mode) {
 				case TD_SINGLE_HOLD: unregister_code16(kc_or_layer); break;
 				case TD_DOUBLE_TAP:  tap_code16(kc_or_layer); break;
 				case TD_DOUBLE_HOLD: unregister_code16(kc_or_layer); break;
+				case TD_DOUBLE_PRESS: unregister_code16(kc_or_layer); break;
 				default: break;
 			}
 			break;
@@ -136,24 +279,29 @@ void reset_action(uint16_t kc_or_layer, tap_dance_mode_t mode) {
 			break;
 		default: break;
 	}
+	scan_profiler_end();
 }	
 
 void tap_dance_quad_reset(tap_dance_state_t *state, void *user_data) {
 	tap_dance_quad_t *quad = (tap_dance_quad_t *)user_data;
 
-    switch (td_state) {
+    switch (quad->state) {
 		case TD_SINGLE_TAP:
-			reset_action(quad->single_tap, quad->single_tap_action);
+			reset_action(quad->single_tap, quad->single_tap_action, quad->state);
 			break;
 		case TD_SINGLE_HOLD:
-			reset_action(quad->single_hold, quad->single_hold_action);
+			reset_action(quad->single_hold, quad->single_hold_action, quad->state);
 			break;
 		case TD_DOUBLE_TAP:
-			reset_action(quad->double_tap, quad->double_tap_action);
+			reset_action(quad->double_tap, quad->double_tap_action, quad->state);
 			break;
 		case TD_DOUBLE_HOLD:
-			reset_action(quad->double_hold, quad->double_hold_action);
+			reset_action(quad->double_hold, quad->double_hold_action, quad->state);
+			break;
+		case TD_DOUBLE_PRESS:
+			reset_action(quad->double_tap, quad->double_tap_action, quad->state);
 			break;
 		default: break;
     }
+	quad->state = TD_NONE;
 }
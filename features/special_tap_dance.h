@@ -13,6 +13,7 @@
 #pragma once
 
 #include "quantum.h"
+#include "histogram.h"
 
 typedef enum {
 	TDM_NO,
@@ -27,6 +28,17 @@ typedef struct {
     uint16_t held;
 } tap_dance_tap_hold_t;
 
+typedef enum {
+    TD_NONE,
+    TD_SINGLE_TAP,
+    TD_SINGLE_HOLD,
+    TD_DOUBLE_TAP,
+	TD_DOUBLE_HOLD,
+	TD_MULTI_TAP,
+	TD_MULTI_HOLD,
+	TD_DOUBLE_PRESS, // Double tap committed on the second press, held until release
+} td_state_t;
+
 typedef struct {
 	uint16_t single_tap;
 	uint16_t single_hold;
@@ -37,6 +49,9 @@ typedef struct {
 	tap_dance_mode_t single_hold_action;
 	tap_dance_mode_t double_tap_action;
 	tap_dance_mode_t double_hold_action;
+	
+	td_state_t state; // Resolved when the dance finishes and cleared on reset
+	uint8_t early;    // TD_EARLY_* flags, worked out from the actions above on the first tap
 } tap_dance_quad_t;
 
 /* Tap Hold
@@ -61,22 +76,56 @@ typedef struct {
  * double_hold_action is performed on the keycode or layer passed to double_hold
  *
  * QUAD_FULL requires all eight arguments. Simplified versions which use fewer arguments are also available.
+ *
+ * Dances commit as soon as the outcome can no longer change instead of waiting for the tapping term.  Without any
+ * double action a single tap is sent on release, and when there is no double hold, or it is the same as the double
+ * tap, the double tap is pressed on the second press.  Define NO_TAP_DANCE_EARLY_COMMIT to always wait.
  */
 #define ACTION_TAP_DANCE_TRI(single_tap, single_hold, single_hold_action, double_tap, double_tap_action) \
-    { .fn = {NULL, tap_dance_quad_finished, tap_dance_quad_reset, NULL}, \
-	  .user_data = (void *)&((tap_dance_quad_t){single_tap, single_hold, double_tap, double_tap, TDM_KC, single_hold_action, double_tap_action, double_tap_action}), }
+    { .fn = {tap_dance_quad_on_each_tap, tap_dance_quad_finished, tap_dance_quad_reset, tap_dance_quad_on_each_release}, \
+	  .user_data = (void *)&((tap_dance_quad_t){single_tap, single_hold, double_tap, double_tap, TDM_KC, single_hold_action, double_tap_action, double_tap_action, TD_NONE, 0}), }
 
 #define ACTION_TAP_DANCE_QUAD(single_tap, single_hold, single_hold_action, double_tap, double_tap_action, double_hold, double_hold_action) \
-    { .fn = {NULL, tap_dance_quad_finished, tap_dance_quad_reset, NULL}, \
-	  .user_data = (void *)&((tap_dance_quad_t){single_tap, single_hold, double_tap, double_hold, TDM_KC, single_hold_action, double_tap_action, double_hold_action}), }
+    { .fn = {tap_dance_quad_on_each_tap, tap_dance_quad_finished, tap_dance_quad_reset, tap_dance_quad_on_each_release}, \
+	  .user_data = (void *)&((tap_dance_quad_t){single_tap, single_hold, double_tap, double_hold, TDM_KC, single_hold_action, double_tap_action, double_hold_action, TD_NONE, 0}), }
 	  
 #define ACTION_TAP_DANCE_QUAD_FULL(single_tap, single_tap_action, single_hold, single_hold_action, double_tap, double_tap_action, double_hold, double_hold_action) \
-    { .fn = {NULL, tap_dance_quad_finished, tap_dance_quad_reset, NULL}, \
-	  .user_data = (void *)&((tap_dance_quad_t){single_tap, single_hold, double_tap, double_hold, single_tap_action, single_hold_action, double_tap_action, double_hold_action}), }
+    { .fn = {tap_dance_quad_on_each_tap, tap_dance_quad_finished, tap_dance_quad_reset, tap_dance_quad_on_each_release}, \
+	  .user_data = (void *)&((tap_dance_quad_t){single_tap, single_hold, double_tap, double_hold, single_tap_action, single_hold_action, double_tap_action, double_hold_action, TD_NONE, 0}), }
 	  
+/* Decision Statistics
+ * Every tap hold and quad dance records how long it took from the first press to the action being committed, which
+ * outcome was chosen and how often Backspace was the very next key within TD_CORRECTION_TIME of the dance resolving.
+ * Call process_tap_dance_stats from process_record_user, passing the keymap's own backspace key if it has one.
+ */
+#ifndef TD_STATS_KEYS
+#define TD_STATS_KEYS 16 // Number of dances, starting from TD(0), that are recorded
+#endif
+
+#ifndef TD_CORRECTION_TIME
+#define TD_CORRECTION_TIME 1000
+#endif
+
+#ifndef TD_STATS_BUCKET
+#define TD_STATS_BUCKET 20 // Width of the decision time histogram buckets, in ms
+#endif
+
+typedef struct {
+	hist_t   wait;                      // Time from the first press to the committed action, in ms
+	uint16_t outcomes[TD_DOUBLE_PRESS]; // Indexed by td_state_t - 1
+	uint16_t corrections;
+} td_stats_t;
+
+void process_tap_dance_stats(uint16_t keycode, keyrecord_t *record, uint16_t backspace);
+const td_stats_t *tap_dance_stats(uint8_t index);
+uint8_t tap_dance_stats_last(void);
+void tap_dance_stats_dump(void);
+
 void tap_dance_tap_hold_on_each_release(tap_dance_state_t *state, void *user_data);
 void tap_dance_tap_hold_finished(tap_dance_state_t *state, void *user_data);
 void tap_dance_tap_hold_reset(tap_dance_state_t *state, void *user_data);
 
+void tap_dance_quad_on_each_tap(tap_dance_state_t *state, void *user_data);
+void tap_dance_quad_on_each_release(tap_dance_state_t *state, void *user_data);
 void tap_dance_quad_finished(tap_dance_state_t *state, void *user_data);
 void tap_dance_quad_reset(tap_dance_state_t *state, void *user_data);
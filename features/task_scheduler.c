@@ -0,0 +1,130 @@
+/* task_scheduler.c
+ *
+ * A small cooperative scheduler for everything in the keymap that runs on a timer. Tasks are kept in a list ordered
+ * by priority and run from housekeeping_task_user, so a due HID task is never stuck behind the OLED. Each scan gets a
+ * budget of SCHED_BUDGET ms: the first due task always runs, and once the budget is spent the remaining due tasks
+ * wait for the next scan.
+ *
+ * Every task records how late it started, how long it ran and how often it was held back, which sched_tasks exposes
+ * for the OLED and console.
+ *
+ * Normally a task's next run is measured from when it started, so lateness adds to its period. Fixed rate tasks are
+ * instead scheduled against ideal deadlines one period apart. A late run is followed by an early one, and when a task
+ * falls a whole period behind the missed runs are skipped and counted rather than played back to back.
+ *
+ * Each run is marked with the task's name for scan_profiler.
+ *
+ * Call sched_run from housekeeping_task_user.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "task_scheduler.h"
+#include "scan_profiler.h"
+#include "quantum.h"
+
+#ifndef SCHED_BUDGET
+#define SCHED_BUDGET 2 // Time per scan after which remaining due tasks are left for the next scan, in ms
+#endif
+
+static sched_task_t *head = NULL;
+
+// Tasks join the list the first time they are started and stay in it so their statistics can be shown
+static void sched_link(sched_task_t *task) {
+	sched_task_t **link = &head;
+
+	while (*link && ((*link)->priority <= task->priority)) {
+		link = &(*link)->next;
+	}
+	task->next = *link;
+	*link = task;
+	task->linked = true;
+}
+
+// Starting a task that is already active moves its next run, which is how one-shot tasks are pushed back
+void sched_start(sched_task_t *task, uint32_t delay) {
+	if (!task->linked) {
+		sched_link(task);
+	}
+	task->due = timer_read32() + delay;
+	task->active = true;
+}
+
+void sched_stop(sched_task_t *task) {
+	task->active = false;
+}
+
+bool sched_active(const sched_task_t *task) {
+	return task->active;
+}
+
+static void sched_record(sched_stats_t *stats, uint32_t late, uint32_t ran) {
+	if (stats->runs == UINT16_MAX) {
+		stats->runs >>= 1;
+		stats->late_total >>= 1;
+	}
+	stats->runs++;
+	stats->late_total += late;
+
+	if (late > stats->late_max) {
+		stats->late_max = (late < UINT16_MAX) ? late : UINT16_MAX;
+	}
+	if (late && (stats->late_runs < UINT16_MAX)) {
+		stats->late_runs++;
+	}
+	if (ran > stats->run_max) {
+		stats->run_max = (ran < UINT16_MAX) ? ran : UINT16_MAX;
+	}
+	if ((ran > SCHED_BUDGET) && (stats->overruns < UINT16_MAX)) {
+		stats->overruns++;
+	}
+}
+
+void sched_run(void) {
+	uint32_t scan_start = timer_read32();
+	bool ran_any = false;
+
+	for (sched_task_t *task = head; task; task = task->next) {
+		uint32_t now = timer_read32();
+
+		if (!task->active || !timer_expired32(now, task->due)) {
+			continue;
+		}
+		if (ran_any && (TIMER_DIFF_32(now, scan_start) >= SCHED_BUDGET)) {
+			if (task->stats.deferred < UINT16_MAX) {
+				task->stats.deferred++;
+			}
+			continue;
+		}
+
+		// The return value decides the next run even if the task restarted or stopped itself
+		uint32_t late = TIMER_DIFF_32(now, task->due);
+		scan_profiler_begin(task->name);
+		uint32_t delay = task->fn();
+		scan_profiler_end();
+		uint32_t end = timer_read32();
+
+		sched_record(&task->stats, late, TIMER_DIFF_32(end, now));
+		ran_any = true;
+
+		if (delay && task->fixed_rate) {
+			task->due += delay;
+			while (timer_expired32(end, task->due + delay)) {
+				task->due += delay;
+				if (task->stats.skipped < UINT16_MAX) {
+					task->stats.skipped++;
+				}
+			}
+			task->active = true;
+		} else if (delay) {
+			task->due = now + delay;
+			task->active = true;
+		} else {
+			task->active = false;
+		}
+	}
+}
+
+const sched_task_t *sched_tasks(void) {
+	return head;
+}
@@ -0,0 +1,58 @@
+/* task_scheduler.h
+ *
+ * Header file for the cooperative task scheduler in keyboard firmware.
+ * Declares named tasks with priorities and statistics, and functions to start, stop and run them.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Returns the number of milliseconds until the task should run again, or 0 to stop it
+typedef uint32_t (*sched_fn_t)(void);
+
+// Lower priorities run first when several tasks are due in the same scan
+typedef enum {
+	SCHED_HID,        // Sends reports to the host
+	SCHED_BACKGROUND, // Housekeeping that can wait a scan or two
+	SCHED_DISPLAY,    // Rendering, only runs once everything else has had its turn
+} sched_priority_t;
+
+typedef struct {
+	uint16_t runs;
+	uint16_t late_max;   // Longest time between being due and starting, in ms
+	uint32_t late_total; // Divide by runs for the average
+	uint16_t run_max;    // Longest single run, in ms
+	uint16_t overruns;   // Runs that took longer than SCHED_BUDGET on their own
+	uint16_t deferred;   // Scans the task was due but waited because the budget was spent
+	uint16_t late_runs;  // Runs that started after their due time
+	uint16_t skipped;    // Fixed rate runs dropped to catch up instead of drifting
+} sched_stats_t;
+
+typedef struct sched_task_t {
+	const char      *name;
+	sched_fn_t       fn;
+	sched_priority_t priority;
+	bool             fixed_rate; // Next run is due one period after the previous due time rather than after it ran
+	bool             active;
+	bool             linked;
+	uint32_t         due;
+	sched_stats_t    stats;
+	struct sched_task_t *next;
+} sched_task_t;
+
+// Tasks are owned by the module that runs them, for example static sched_task_t task = SCHED_TASK("Name", ...);
+#define SCHED_TASK(name, priority, fn) {name, fn, priority, false}
+
+// For frame clocks and other work that should keep an exact average rate, whole periods are skipped when it falls behind
+#define SCHED_TASK_FIXED(name, priority, fn) {name, fn, priority, true}
+
+void sched_start(sched_task_t *task, uint32_t delay);
+void sched_stop(sched_task_t *task);
+bool sched_active(const sched_task_t *task);
+
+void sched_run(void);
+const sched_task_t *sched_tasks(void);
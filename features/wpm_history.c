@@ -0,0 +1,72 @@
+/* wpm_history.c
+ *
+ * Keeps the last WPM_HISTORY_LEN samples of typing speed in a ring buffer, one every WPM_HISTORY_INTERVAL, which is
+ * a little over four minutes with the defaults. Each sample holds the WPM EMA at that moment and the highest raw
+ * WPM since the previous sample, so short bursts still show up between samples.
+ *
+ * Requires task_scheduler.c. Call wpm_history_start from keyboard_post_init_user and feed the current speeds to
+ * wpm_history_observe whenever the EMA is updated.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "wpm_history.h"
+#include "task_scheduler.h"
+
+#ifndef WPM_HISTORY_INTERVAL
+#define WPM_HISTORY_INTERVAL 2000 // Time between samples, in ms
+#endif
+
+static wpm_sample_t samples[WPM_HISTORY_LEN];
+static uint8_t  head = 0;  // Where the next sample goes
+static uint8_t  filled = 0;
+static uint16_t count = 0; // Samples taken, wraps but only differences between counts matter
+
+static uint8_t last_average = 0;
+static uint8_t peak = 0;
+
+static uint8_t clamp_wpm(uint16_t wpm) {
+	return (wpm > UINT8_MAX) ? UINT8_MAX : wpm;
+}
+
+void wpm_history_observe(uint16_t average, uint16_t wpm) {
+	last_average = clamp_wpm(average);
+
+	if (clamp_wpm(wpm) > peak) {
+		peak = clamp_wpm(wpm);
+	}
+}
+
+static uint32_t wpm_history_task(void) {
+	samples[head].average = last_average;
+	samples[head].peak = (peak > last_average) ? peak : last_average;
+	head = (head + 1) % WPM_HISTORY_LEN;
+	count++;
+	peak = 0;
+
+	if (filled < WPM_HISTORY_LEN) {
+		filled++;
+	}
+
+	return WPM_HISTORY_INTERVAL;
+}
+
+static sched_task_t sample_task = SCHED_TASK_FIXED("WPM", SCHED_BACKGROUND, wpm_history_task);
+
+void wpm_history_start(void) {
+	sched_start(&sample_task, WPM_HISTORY_INTERVAL);
+}
+
+// Age 0 is the newest sample, returns false for ages that have not been sampled yet
+bool wpm_history_get(uint8_t age, wpm_sample_t *sample) {
+	if (age >= filled) {
+		return false;
+	}
+	*sample = samples[(head + WPM_HISTORY_LEN - 1 - age) % WPM_HISTORY_LEN];
+	return true;
+}
+
+// Compare against an earlier count to find how many samples are new
+uint16_t wpm_history_count(void) {
+	return count;
+}
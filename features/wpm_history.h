@@ -0,0 +1,28 @@
+/* wpm_history.h
+ *
+ * Header file for recording typing speed over time in keyboard firmware.
+ * Declares the sample format, and functions to feed in the current speed, start sampling and read back samples by age.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Samples kept, one graph column each
+#ifndef WPM_HISTORY_LEN
+#define WPM_HISTORY_LEN 128
+#endif
+
+typedef struct {
+	uint8_t average; // The WPM EMA when the sample was taken
+	uint8_t peak;    // Highest raw WPM seen since the sample before
+} wpm_sample_t;
+
+void wpm_history_start(void);
+void wpm_history_observe(uint16_t average, uint16_t wpm);
+
+bool wpm_history_get(uint8_t age, wpm_sample_t *sample);
+uint16_t wpm_history_count(void);
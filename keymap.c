@@ -5,7 +5,6 @@
  *
  * Requires the following features in rules.mk:
  *
- * DEFERRED_EXEC_ENABLE = yes
  * DYNAMIC_MACRO_ENABLE = yes
  * MOUSEKEY_ENABLE = yes
  * TAP_DANCE_ENABLE = yes
@@ -23,6 +22,15 @@
 #include "features/send_string_macros.h"
 #include "features/mouse_jiggler.h"
 #include "features/select_word.h"
+#include "features/task_scheduler.h"
+#include "features/scan_profiler.h"
+#include "features/key_latency.h"
+#include "features/particles.h"
+#include "features/life.h"
+#include "features/wpm_history.h"
+#include "features/notice_queue.h"
+#include "features/macro_executor.h"
+#include "features/adaptive_tapping_term.h"
 
 #include <stdio.h>
 #include <stdarg.h>
@@ -64,6 +72,7 @@ enum custom_keycodes {
 	CAPS_IME, CTRL_OCR, CTRL_RGT, GUI_SNIP,
 	TD_FN_LH, TD_F13_L, TD_HOME,  TD_END,
 	TD_PGUP,  TD_PGDN,
+	TD_COUNT,
 	
 /* Custom Keycodes are for behaviors that require new code to implement. Creating a custom keycode is more
  * complex than a Tap Dance or Macro, so consider whether those simpler features will work first.
@@ -75,6 +84,7 @@ enum custom_keycodes {
 	BKSP_UP, BKSP_DN,
 	EROM_SV, EROM_LD,
 	M_JIGGL, SELWORD,
+	TERM_AD, DBG_DMP,
 	
 /* Macro Keycodes perform a single SEND_STRING command when pressed and also display their type and name
  * on the OLED display when activated. They are useful for macros and keyboard shortcuts ranging from 
@@ -133,8 +143,8 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 	_______,      _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______,       _______, _______,
 	_______,      _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, QK_BOOT,       LED_ANI, LED_BUP,
 	_______,      BASE_UP, CTRL_UP, BKSP_UP, _______, _______, _______, _______, _______, _______, _______, _______, _______, EE_CLR,        LED_INF, LED_BDN,
-	_______,      BASE_DN, CTRL_DN, BKSP_DN, _______, _______, _______, _______, _______, _______, _______, _______,          EROM_SV,
-	_______,      _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, EROM_LD,          _______,       _______,
+	_______,      BASE_DN, CTRL_DN, BKSP_DN, TERM_AD, _______, _______, _______, _______, _______, _______, _______,          EROM_SV,
+	_______,      _______, _______, _______, DBG_DMP, _______, _______, _______, _______, _______, _______, EROM_LD,          _______,       _______,
 	_______,      _______, _______,                            _______,                                     _______, _______, _______,       _______, _______
   ),
 
@@ -155,9 +165,18 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 enum {
 	OLED_TOTORO, OLED_NEKO, OLED_GHOST, OLED_WHALE, OLED_GIRL, OLED_DEMON, OLED_MAI,
 	OLED_FACES,  OLED_CAT, OLED_CHARACTERS,
+	OLED_RAIN,   OLED_SNOW, OLED_SPARKS, OLED_LIFE, OLED_GRAPH, OLED_SPEED,
 	OLED_ENUM_COUNT
 };
 
+// Pages shown by LED_INF in order, pressing it on the last page turns the display off
+enum {
+	INFO_STATUS, INFO_TAP_DANCE, INFO_LATENCY, INFO_TASKS, INFO_SCAN,
+	INFO_ENUM_COUNT
+};
+
+static uint8_t info_page = INFO_STATUS;
+
 // The initial value of the buffer will be displayed when the keyboard is first powered on
 char show_buffer[SHOW_LEN] =
 	"\n\n"
@@ -165,7 +184,8 @@ char show_buffer[SHOW_LEN] =
 	"   \xA5\xA6\xA7\xA8\xA9\xAA\xAB\xAC\xAD\xAE\xAF\xB0\xB1\xB2\xB3\n"
 	"   \xC5\xC6\xC7\xC8\xC9\xCA\xCB\xCC\xCD\xCE\xCF\xD0\xD1\xD2\xD3\n";
 
-static uint32_t note_timer = 0;
+// Shown until OLED_NOTE_TIME after power on or until the first notice, whichever is sooner
+static bool splash = true;
 
 // =========================
 // = Keycode Configuration =
@@ -190,10 +210,19 @@ tap_dance_action_t tap_dance_actions[] = {
 	[TD_PGDN]  = ACTION_TAP_DANCE_DOUBLE(KC_PGDN, LCTL(KC_MINS)),
 };
 
+#ifdef MACRO_SHARED_SEQUENCES
+// Sequences shared by the SS_START and SS_BROWSE helpers, see send_string_macros.h
+const char *const macro_subroutines[SUB_COUNT] = {
+	[SUB_START]  = SUB_START_SEQ,
+	[SUB_LAUNCH] = SUB_LAUNCH_SEQ,
+	[SUB_BROWSE] = SUB_BROWSE_SEQ,
+};
+#endif
+
 // Macros are configured as a SEND_STRING along with a type and name that are displayed when run
 macro_info_t macro_info[] = {
 	[M(M_AUTHR)] = MACRO("Print", "Author Name", "Keymap Author: Ryan Turner\n"),
-	[M(M_TWTCH)] = MACRO("Web", "Twitch.tv", SS_START("firefox") SS_LCTL("l") "twitch.tv/directory/category/starcraft" SS_LCTL("\n")),
+	[M(M_TWTCH)] = MACRO_P("Web", "Twitch.tv", MQ_COALESCE, SS_START("firefox") SS_LCTL("l") "twitch.tv/directory/category/starcraft" SS_LCTL("\n")),
 	
 	[M(MPDF_SV)] = MACRO("Adobe PDF", "Save to Desktop", SS_LCTL(SS_LSFT("s")) SS_DELAY(300) REPT(SS_TAP(X_TAB), 5)
 														 SS_TAP(X_ENT) SS_DELAY(300) SS_LCTL("l") "Desktop" REPT(SS_TAP(X_ENT), 3)),
@@ -204,17 +233,38 @@ macro_info_t macro_info[] = {
 
 // Custom keycodes that do not fall into the above categories can be implemented here
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
-	if (!process_select_word(keycode, record, SELWORD)) { return false; }
+	process_adaptive_term(keycode, record);
+	process_tap_dance_stats(keycode, record, TD(BKSP_BSL));
+	
+	// Presses that send a report right away are timed by key_latency, tap dances arm it themselves once they decide
+	if (record->event.pressed) {
+		if (keycode == SELWORD) {
+			key_latency_arm(KL_SELECT_WORD, record->event.time);
+		} else if (keycode <= QK_MODS_MAX) {
+			key_latency_arm(KL_PLAIN, record->event.time);
+		}
+	}
+	
+	// Each key drops a glider into the Life grid under its place on the keyboard
+	if (record->event.pressed && (oled_state == OLED_LIFE)) {
+		life_inject((record->event.key.col * 128) / MATRIX_COLS, (record->event.key.row * 64) / MATRIX_ROWS);
+	}
+	
+	scan_profiler_begin("SelWord");
+	bool select_word_done = !process_select_word(keycode, record, SELWORD);
+	scan_profiler_end();
+	if (select_word_done) { return false; }
+	
 	if (record->event.pressed) {
 		switch (keycode) {
 			// OLED Config
 			case LED_BUP:
-				adjust_setting(&oled_bri, 10, 0, 250); // Do not change constants as eeprom packs these into 6 bits
+				adjust_setting(&oled_bri, 10, 0, OLED_BRI_MAX);
 				oled_set_brightness (oled_bri);
 				break;
 				
 			case LED_BDN:
-				adjust_setting(&oled_bri, -10, 0, 250);
+				adjust_setting(&oled_bri, -10, 0, OLED_BRI_MAX);
 				oled_set_brightness (oled_bri);
 				break;
 				
@@ -224,33 +274,77 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 						oled_show_info = false;
 					} else {
 						oled_state = (oled_state + 1) % OLED_ENUM_COUNT;
+						render_transition(OLED_TRANSITION_FRAMES);
 					}
 				} else {
 					oled_enabled = true;
 					oled_show_info = false;
 				}
+				settings_mark_dirty();
 				break;
 				
 			case LED_INF:
-				if (oled_enabled) {
-					if (oled_show_info) {
-						oled_enabled = false;
+				if (oled_enabled && oled_show_info) {
+					if (info_page + 1 < INFO_ENUM_COUNT) {
+						info_page++;
 					} else {
-						oled_show_info = true;
+						oled_enabled = false;
 					}
 				} else {
 					oled_enabled = true;
 					oled_show_info = true;
+					info_page = INFO_STATUS;
 				}
+				settings_mark_dirty();
 				break;
 			
 			// Tap Delay Config
-			case BASE_UP: adjust_setting(&delay_base,  5, 100, 320); break; // Do not change constants as eeprom packs these into 6 bits
-			case BASE_DN: adjust_setting(&delay_base, -5, 100, 320); break; // Zeroing delay_base can lock you out of LAYER_CONFIG
-			case CTRL_UP: adjust_setting(&delay_ctrl,  5, 10,  320); break;
-			case CTRL_DN: adjust_setting(&delay_ctrl, -5, 10,  320); break;
-			case BKSP_UP: adjust_setting(&delay_bksp,  5, 10,  320); break;
-			case BKSP_DN: adjust_setting(&delay_bksp, -5, 10,  320); break;
+			case BASE_UP: adjust_setting(&delay_base,  5, DELAY_BASE_MIN, DELAY_MAX); break;
+			case BASE_DN: adjust_setting(&delay_base, -5, DELAY_BASE_MIN, DELAY_MAX); break;
+			case CTRL_UP: adjust_setting(&delay_ctrl,  5, DELAY_MIN,      DELAY_MAX); break;
+			case CTRL_DN: adjust_setting(&delay_ctrl, -5, DELAY_MIN,      DELAY_MAX); break;
+			case BKSP_UP: adjust_setting(&delay_bksp,  5, DELAY_MIN,      DELAY_MAX); break;
+			case BKSP_DN: adjust_setting(&delay_bksp, -5, DELAY_MIN,      DELAY_MAX); break;
+			case TERM_AD:
+				adaptive_term_enabled = !adaptive_term_enabled;
+				settings_mark_dirty();
+				break;
+			
+			// Statistics, printed to the console when CONSOLE_ENABLE = yes
+			case DBG_DMP: {
+				const macro_queue_stats_t *mq = macro_queue_stats();
+				const settings_save_stats_t *ss = settings_save_stats();
+				
+				show_feature("Console", "Dump Stats");
+				tap_dance_stats_dump();
+				uprintf("Macros queued %u started %u dropped %u merged %u cancelled %u wait max %lu avg %lu\n",
+					mq->queued, mq->started, mq->dropped, mq->coalesced, mq->cancelled,
+					(unsigned long)mq->wait_max, (unsigned long)(mq->started ? mq->wait_total / mq->started : 0));
+				uprintf("Settings written %u skipped %u\n", ss->writes, ss->avoided);
+				uprintf("Jiggler reports %lu\n", (unsigned long)jiggle_reports_sent());
+				uprintf("Notices dropped %u\n", notice_dropped());
+				
+				for (uint8_t path = 0; path < KL_PATH_COUNT; path++) {
+					const hist_t *hist = key_latency(path);
+					uprintf("Latency %s n %u avg %u p90 %u max %u\n", key_path_names[path], hist->count,
+						hist_mean(hist), hist_percentile(hist, 90), hist->max);
+				}
+				uprintf("Latency expired %u\n", key_latency_expired());
+				
+				const scan_stats_t *scan = scan_profiler_stats();
+				uprintf("Scan avg %u p99 %u max %u stalls %u\n", hist_mean(&scan->interval),
+					hist_percentile(&scan->interval, 99), scan->interval.max, scan->stalls);
+				for (uint8_t i = 0; (i < SCAN_STALL_TAGS) && scan->stall[i].tag; i++) {
+					uprintf("  %s %u worst %u\n", scan->stall[i].tag, scan->stall[i].count, scan->stall[i].worst);
+				}
+				
+				for (const sched_task_t *task = sched_tasks(); task; task = task->next) {
+					const sched_stats_t *ts = &task->stats;
+					uprintf("Task %s runs %u late %u max %u run max %u deferred %u skipped %u\n", task->name, ts->runs,
+						ts->late_runs, ts->late_max, ts->run_max, ts->deferred, ts->skipped);
+				}
+				break;
+			}
 			
 			// EEPROM
 			case EROM_SV:
@@ -276,22 +370,20 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 				
 			default:
 				/* Macros configured using macro_info are processed here.
-				 * send_string is called using defer_exec to allow the OLED to update first,
-				 * otherwise macros with delays will cause the display to freeze.
+				 * macro_executor types the macro a few keys at a time between matrix scans, so the OLED
+				 * and the rest of the keyboard keep running while it plays, including through any SS_DELAY.
+				 * Presses made while a macro is playing are handled according to the macro's policy.
 				 */
-				static int macro_index = -1; // Malloc would allow simultaneous presses but seems unnecessary
-				
-				if ((keycode > MACRO_RANGE_START) && (keycode < MACRO_RANGE_END) && (macro_index == -1)) {
-					macro_index = M_INDEX(keycode);
-					show_macro(macro_info[macro_index].type, macro_info[macro_index].name);
+				if ((keycode > MACRO_RANGE_START) && (keycode < MACRO_RANGE_END)) {
+					macro_info_t *macro = &macro_info[M_INDEX(keycode)];
 					
-					uint32_t send_string_deferred(uint32_t trigger_time, void *cb_arg) {
-						send_string_with_delay(macro_info[macro_index].macro, DYNAMIC_MACRO_DELAY);
-						macro_index = -1;
-						return 0;
+					// Only a macro that starts right away sends the next report
+					if (!macro_exec_busy()) {
+						key_latency_arm(KL_MACRO, record->event.time);
+					}
+					if (macro_exec_queue(macro->macro, macro->policy, DYNAMIC_MACRO_DELAY)) {
+						show_macro(macro->type, macro->name);
 					}
-					defer_exec((1000 / OLED_FPS) + 1, send_string_deferred, NULL);
-					break;
 				}
 				break;
 		}
@@ -302,60 +394,183 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 // =============
 // = Tap Delay =
 // =============
+// Each tap dance key uses its learned term when it has one, see adaptive_tapping_term.c
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
     switch (keycode) {
         case TD(CTRL_OCR):
-            return delay_ctrl;
+            return adaptive_term_get(keycode, delay_ctrl);
 		case TD(CTRL_RGT):
-			return delay_ctrl;
+			return adaptive_term_get(keycode, delay_ctrl);
 		case TD(BKSP_BSL):
-			return delay_bksp;
+			return adaptive_term_get(keycode, delay_bksp);
         default:
-            return delay_base;
+            return adaptive_term_get(keycode, delay_base);
     }
 }
 
+// Learned terms are saved with the other settings once typing goes quiet
+void adaptive_term_changed_user(uint8_t index) {
+	settings_mark_dirty();
+}
+
 // ================
 // = OLED Display =
 // ================
-// Does some housekeeping for oled_task_user
+// Does some housekeeping for oled_render_task
 bool oled_task_prep(void) {
-	static uint32_t frame_timer = 0;
 	static uint16_t oled_last_state = 0;
 	
-	if (timer_elapsed32(frame_timer) < (1000 / OLED_FPS)) {
-		return false;
-	} else {
-		frame_timer = timer_read32();
-	}
-	
 	if (!oled_enabled) {
 		oled_off();
 		return false;
 	}
 	
-	if (oled_last_state != oled_show_info) {
+	// Each info page counts as its own state so that switching pages clears the display
+	uint16_t state = oled_show_info ? info_page + 1 : 0;
+	if (oled_last_state != state) {
 		oled_clear();
-		oled_last_state = oled_show_info;
+		oled_last_state = state;
 	}
 	
 	return true;
 }
 
-// OLED Display is implemented here
-bool oled_task_user(void) {
-	if (!oled_task_prep()) {
-		return false;
+// The WPM EMA as a filled sparkline with the peak WPM as a dot above it, newest sample on the right
+static uint64_t wpm_graph_column(uint8_t x) {
+	wpm_sample_t sample;
+	
+	if (!wpm_history_get(127 - x, &sample)) {
+		return 0;
 	}
+	uint8_t top = 64 - scale_value_lim(sample.average, 0, WPM_MAX, 0, 64);
+	uint8_t dot = 63 - scale_value_lim(sample.peak, 0, WPM_MAX, 0, 63);
 	
+	return ((top < 64) ? (UINT64_MAX << top) : 0) | (1ULL << dot);
+}
+
+// OLED Display is implemented here, the scheduler runs this once per frame
+static uint32_t oled_render_task(void) {
+	// The average keeps going while the display is off so that wpm_history has something to sample
 	static int fp_wpm_ema = 0;
 	fp_wpm_ema = (((int)get_current_wpm() * FP_DIV * WPM_EMA_ALPHA) + (fp_wpm_ema * (FP_DIV - WPM_EMA_ALPHA))) / FP_DIV;
+	wpm_history_observe(fp_wpm_ema / FP_DIV, get_current_wpm());
+	
+	if (!oled_task_prep()) {
+		return 1000 / OLED_FPS;
+	}
+	oled_set_cursor(0, 0);
+	
+	// Modes that only redraw what changed need to know what the last frame was, anything other than an image mode
+	// leaves this at OLED_ENUM_COUNT
+	static uint8_t drawn_state = OLED_ENUM_COUNT;
+	uint8_t last_drawn = drawn_state;
+	drawn_state = OLED_ENUM_COUNT;
 	
-	if (timer_elapsed32(note_timer) <= OLED_NOTE_TIME) {
+	// Notices from show_macro and show_feature are drawn as a banner over the top of the image modes
+	const notice_t *notice = notice_current();
+	
+	if (splash && (notice || (timer_read32() > OLED_NOTE_TIME))) {
+		splash = false;
+	}
+	
+	if (splash) {
+		// ===============
+		// = Boot Splash =
+		// ===============
+		oled_write_ln(show_buffer, false);
+		
+	} else if (notice && oled_show_info) {
 		// ==================
 		// = Display Notice =
 		// ==================
-		// If there is a notice it will have already been written to the buffer
+		// Info pages have no animation to keep running, so the notice takes the whole screen
+		for (uint8_t row = 0; row < 8; row++) {
+			oled_write_ln((row < NOTICE_LINES) ? notice->lines[row] : "", false);
+		}
+		
+	} else if (oled_show_info && (info_page == INFO_LATENCY)) {
+		// ===================
+		// = Display Latency =
+		// ===================
+		// Time from a press to the report that carries it, in ms, for each path a key can take
+		// Rows are kept to 20 characters so none of them wraps, larger values are capped
+		snprintf(show_buffer, SHOW_LEN, " Latency   N Avg Max\n");
+		
+		for (uint8_t path = 0; path < KL_PATH_COUNT; path++) {
+			const hist_t *hist = key_latency(path);
+			uint16_t mean = hist_mean(hist);
+			
+			snprintf_append(show_buffer, SHOW_LEN, " %-7s%4u %3u %3u\n", key_path_names[path], MIN(hist->count, 9999),
+				MIN(mean, 999), MIN(hist->max, 999));
+		}
+		
+		oled_write(show_buffer, false);
+		
+	} else if (oled_show_info && (info_page == INFO_SCAN)) {
+		// ================
+		// = Display Scan =
+		// ================
+		// Matrix scan intervals in ms, followed by the features that stalls were blamed on. Values are capped so that
+		// rows stay within 20 characters
+		const scan_stats_t *scan = scan_profiler_stats();
+		uint16_t p50 = hist_percentile(&scan->interval, 50);
+		uint16_t p99 = hist_percentile(&scan->interval, 99);
+		
+		snprintf(show_buffer, SHOW_LEN, " Scan P50<%u P99<%u\n", MIN(p50, 99), MIN(p99, 99));
+		snprintf_append(show_buffer, SHOW_LEN, " Max:%u Hold:%u\n", MIN(scan->interval.max, 9999), MIN(scan->hold, 9999));
+		snprintf_append(show_buffer, SHOW_LEN, " Stalls: %u\n", scan->stalls);
+		
+		for (uint8_t i = 0; (i < 5) && scan->stall[i].tag; i++) {
+			snprintf_append(show_buffer, SHOW_LEN, " %-8.8s%4u %4ums\n", scan->stall[i].tag,
+				MIN(scan->stall[i].count, 9999), MIN(scan->stall[i].worst, 9999));
+		}
+		
+		oled_write(show_buffer, false);
+		
+	} else if (oled_show_info && (info_page == INFO_TASKS)) {
+		// =================
+		// = Display Tasks =
+		// =================
+		// Worst lateness and worst run time in ms for each scheduler task, how often the budget held it back and, for
+		// fixed rate tasks such as the OLED frame clock, how many runs were skipped entirely. Values are capped so that
+		// rows stay within 20 characters, DBG_DMP prints the full counts along with the number of late runs
+		snprintf(show_buffer, SHOW_LEN, " Task    Lt Rn Df Sk\n");
+		
+		for (const sched_task_t *task = sched_tasks(); task; task = task->next) {
+			snprintf_append(show_buffer, SHOW_LEN, " %-7.7s%3u%3u%3u%3u\n", task->name, MIN(task->stats.late_max, 99),
+				MIN(task->stats.run_max, 99), MIN(task->stats.deferred, 99), MIN(task->stats.skipped, 99));
+		}
+		
+		oled_write(show_buffer, false);
+		
+	} else if (oled_show_info && (info_page == INFO_TAP_DANCE)) {
+		// =====================
+		// = Display Tap Dance =
+		// =====================
+		// Shows the statistics of whichever dance resolved last, tap the dance you are interested in. Values are capped
+		// so that rows stay within 20 characters
+		uint8_t index = tap_dance_stats_last();
+		const td_stats_t *stats = tap_dance_stats(index);
+		
+		if (!stats) {
+			snprintf(show_buffer, SHOW_LEN, "\n Tap Dance\n\n Tap a dance key to\n see its statistics");
+		} else {
+			const uint16_t *outcomes = stats->outcomes;
+			
+			snprintf(show_buffer, SHOW_LEN, " Tap Dance %d\n", index);
+			snprintf_append(show_buffer, SHOW_LEN, " Count:%u Fix:%u\n", MIN(stats->wait.count, 9999),
+				MIN(stats->corrections, 9999));
+			snprintf_append(show_buffer, SHOW_LEN, " Wait: %ums avg\n", MIN(hist_mean(&stats->wait), 9999));
+			snprintf_append(show_buffer, SHOW_LEN, " P50<%u P90<%u\n", MIN(hist_percentile(&stats->wait, 50), 9999),
+				MIN(hist_percentile(&stats->wait, 90), 9999));
+			snprintf_append(show_buffer, SHOW_LEN, " Max: %ums\n", MIN(stats->wait.max, 9999));
+			snprintf_append(show_buffer, SHOW_LEN, " 1T%-4u1H%-4u2P%u\n", MIN(outcomes[TD_SINGLE_TAP - 1], 999),
+				MIN(outcomes[TD_SINGLE_HOLD - 1], 999), MIN(outcomes[TD_DOUBLE_PRESS - 1], 999));
+			snprintf_append(show_buffer, SHOW_LEN, " 2T%-4u2H%-4uM%u", MIN(outcomes[TD_DOUBLE_TAP - 1], 999),
+				MIN(outcomes[TD_DOUBLE_HOLD - 1], 999),
+				MIN(outcomes[TD_MULTI_TAP - 1] + outcomes[TD_MULTI_HOLD - 1], 999));
+		}
+		
 		oled_write_ln(show_buffer, false);
 		
 	} else if (oled_show_info) {
@@ -408,6 +623,8 @@ bool oled_task_user(void) {
 			snprintf_append(show_buffer, SHOW_LEN, " Base Delay: %dms\n", delay_base);
 			snprintf_append(show_buffer, SHOW_LEN, " Ctrl Delay: %dms\n", delay_ctrl);
 			snprintf_append(show_buffer, SHOW_LEN, " Bksp Delay: %dms\n", delay_bksp);
+			snprintf_append(show_buffer, SHOW_LEN, " Adaptive: %s %d/%d\n", adaptive_term_enabled ? "On" : "Off",
+				adaptive_term_count(), TD_COUNT);
 			snprintf_append(show_buffer, SHOW_LEN, "\n Brightness: %d/250", oled_bri);
 		}
 		
@@ -422,29 +639,44 @@ bool oled_task_user(void) {
 		static int fp_velocity = 0;
 		static int fp_target = 0;
 		
+		static mask_t render_mask;
+		
+		// A notice keeps the top of the display while the frame underneath carries on
+		render_banner(notice ? NOTICE_LINES : 0);
+		
 		// Scale WPM into the range 0-64 so that it can be used as a vertical pixel count
 		uint16_t mask = scale_value_lim(fp_wpm_ema / FP_DIV, WPM_MIN, WPM_MAX, 0, 64);
 		
 		if (oled_state == OLED_TOTORO) {
-			split_render(64 - mask, TOTORO_FULL, TOTORO_FRONT);
+			split_render(64 - mask, ASSET(TOTORO_FULL), ASSET(TOTORO_FRONT));
 			
 		} else if (oled_state == OLED_NEKO) {
-			split_render(mask, NEKO_FULL, NEKO_FRONT);
+			split_render(mask, ASSET(NEKO_FULL), ASSET(NEKO_FRONT));
 			
 		} else if (oled_state == OLED_GHOST) {
-			split_render(mask, GHOST_FULL, GHOST_FRONT);
+			split_render(mask, ASSET(GHOST_FULL), ASSET(GHOST_FRONT));
 			
 		} else if (oled_state == OLED_WHALE) {
-			split_render(64 - mask, WHALE_FRONT, WHALE_FULL);
+			// The water line waves a little faster the faster you type, and lies flat at rest like the other images
+			static uint16_t phase_fp = 0;
+			phase_fp += 8 + mask / 4;
+			
+			mask_waterline(&render_mask, 64 - mask, mask ? 3 : 0, phase_fp / 16);
+			mask_render(&render_mask, ASSET(WHALE_FRONT), ASSET(WHALE_FULL));
 			
 		} else if (oled_state == OLED_GIRL) {
-			split_render(mask, GIRL_TWO, GIRL_ONE);	
+			// The second picture wipes in along a slanted edge, from none of it at rest to all of it at WPM_MAX
+			int16_t edge = (mask * 3) / 2;
+			mask_diagonal(&render_mask, edge, edge - 32);
+			mask_render(&render_mask, ASSET(GIRL_TWO), ASSET(GIRL_ONE));
 			
 		} else if (oled_state == OLED_DEMON) {
-			split_render(mask, DEMON_INV, DEMON);	
+			// The inverted demon opens out from its face
+			mask_iris(&render_mask, 68, 28, (mask * 5) / 4);
+			mask_render(&render_mask, ASSET(DEMON_INV), ASSET(DEMON));
 			
 		} else if (oled_state == OLED_MAI) {
-			split_render(64 - mask, MAI_FRONT, MAI_FULL);	
+			split_render(64 - mask, ASSET(MAI_FRONT), ASSET(MAI_FULL));	
 			
 		} else if (oled_state == OLED_FACES) {
 			// Scroll using fp_wpm_ema / WPM_DIV as velocity
@@ -492,21 +724,111 @@ bool oled_task_user(void) {
 				fp_position = (fp_position + CHARACTERS_HEIGHT * FP_DIV) % (CHARACTERS_HEIGHT * FP_DIV);
 			}
 			v_scroll_render(fp_position / FP_DIV, CHARACTERS, CHARACTERS_HEIGHT);
+			
+		} else if ((oled_state == OLED_RAIN) || (oled_state == OLED_SNOW) || (oled_state == OLED_SPARKS)) {
+			// From a quarter of a particle per frame up to eight at WPM_MAX
+			uint16_t spawn_rate = (PARTICLE_FP / 4) + ((mask * PARTICLE_FP) / 8);
+			
+			particles_update(PARTICLE_RAIN + (oled_state - OLED_RAIN), spawn_rate);
+			render_overlay(particles_draw_page);
+			
+			if (oled_state == OLED_RAIN) {
+				split_render(0, ASSET(TOTORO_FRONT), ASSET(TOTORO_FRONT));
+			} else {
+				blank_render();
+			}
+			
+		} else if (oled_state == OLED_LIFE) {
+			// An empty grid starts again from a new random soup
+			if (!life_population()) {
+				life_seed();
+			}
+			life_step();
+			
+			// Living cells show Totoro in negative, so the picture is drawn out by the cells as they move over it
+			bitmap_mask_render(ASSET(life_cells()), ASSET_FLAGS(TOTORO_FRONT, ASSET_INVERT), ASSET(TOTORO_FRONT));
+			
+		} else if (oled_state == OLED_GRAPH) {
+			// Scroll in the samples taken since the last frame, unless the last frame was some other mode
+			static uint16_t graph_count = 0;
+			uint16_t new_samples = wpm_history_count() - graph_count;
+			
+			graph_count = wpm_history_count();
+			scroll_render(((last_drawn == OLED_GRAPH) && (new_samples < 128)) ? new_samples : 128, wpm_graph_column);
+			
+		} else if (oled_state == OLED_SPEED) {
+			gauge_render(fp_wpm_ema / FP_DIV, WPM_MAX, last_drawn != OLED_SPEED);
+		}
+		drawn_state = oled_state;
+		
+		// Frames leave the banner alone, so its text only needs writing when the notice changes or the display
+		// was showing something else
+		static const notice_t *drawn_notice = NULL;
+		static uint8_t drawn_version = 0;
+		
+		if (notice && ((notice != drawn_notice) || (notice->version != drawn_version) || (last_drawn == OLED_ENUM_COUNT))) {
+			const char *lines[NOTICE_LINES] = { notice->lines[0], notice->lines[1] };
+			banner_draw(lines);
 		}
+		drawn_notice = notice;
+		drawn_version = notice ? notice->version : 0;
 	}
-    return false;
+	return 1000 / OLED_FPS;
+}
+
+// Rendering happens in oled_render_task so that it only runs once the HID tasks have had their turn. QMK sends the
+// changed parts of the frame over I2C after this returns, which is marked until the next scan or task starts
+bool oled_task_user(void) {
+	scan_profiler_begin("Flush");
+	return false;
+}
+
+// =========
+// = Tasks =
+// =========
+// Everything that runs on a timer is a task in task_scheduler, including the OLED frames
+static uint32_t select_word_tick(void) {
+	select_word_task();
+	return 100;
+}
+
+static sched_task_t oled_task = SCHED_TASK_FIXED("OLED", SCHED_DISPLAY, oled_render_task);
+static sched_task_t select_word_sched = SCHED_TASK("SelWord", SCHED_BACKGROUND, select_word_tick);
+
+void keyboard_post_init_user(void) {
+	load_settings();
+	sched_start(&oled_task, 0);
+	sched_start(&select_word_sched, 0);
+	wpm_history_start();
 }
 
+void housekeeping_task_user(void) {
+	sched_run();
+}
+
+void matrix_scan_user(void) {
+	scan_profiler_task();
+	key_latency_task();
+}
+
+// Macros are sent often, so their notices wait behind everything else and a newer macro of the same type replaces
+// one that is still waiting
 void show_macro(const char* type, const char* name) {
-	note_timer = timer_read32();
-	snprintf(show_buffer, SHOW_LEN, "\n Send Macro\n Type\x1A%s\n Name\x1A%s", type, name);
-	oled_clear();
+	char title[NOTICE_LEN];
+	char text[NOTICE_LEN];
+	
+	snprintf(title, NOTICE_LEN, " Macro\x1A%s", type);
+	snprintf(text, NOTICE_LEN, " %s", name);
+	notice_push(NOTICE_LOW, OLED_NOTE_TIME, title, text);
 }
 
 void show_feature(const char* type, const char* name) {
-	note_timer = timer_read32();
-	snprintf(show_buffer, SHOW_LEN, "\n Feature\n Type\x1A%s\n Name\x1A%s", type, name);
-	oled_clear();
+	char title[NOTICE_LEN];
+	char text[NOTICE_LEN];
+	
+	snprintf(title, NOTICE_LEN, " %s", type);
+	snprintf(text, NOTICE_LEN, " \x1A%s", name);
+	notice_push(NOTICE_NORMAL, OLED_NOTE_TIME, title, text);
 }
 
 // Convenience function that appends to a string using printf.
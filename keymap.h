@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include "features/macro_executor.h"
+
 // These may or may not already be defined by QMK dependencies
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -32,6 +34,9 @@
 #define WPM_EMA_ALPHA 200 // Alpha is stored in fixed point
 #define WPM_DIV 20 // Conversion ratio where velocity = wpm / WPM_DIV
 
+// Frames taken to dither from one image to the next when LED_ANI is pressed
+#define OLED_TRANSITION_FRAMES 16
+
 
 int closestMultiple(int n, int m);
 
@@ -46,9 +51,12 @@ typedef struct {
 	const char* type;
 	const char* name;
 	const char* macro;
+	macro_policy_t policy;
 } macro_info_t;
 
-#define MACRO(type, name, send_string) {type, name, send_string}
+// Presses made while another macro is playing are queued by default, see macro_policy_t for the alternatives
+#define MACRO(type, name, send_string) {type, name, send_string, MQ_QUEUE}
+#define MACRO_P(type, name, policy, send_string) {type, name, send_string, policy}
 
 // Macros to convert from macro_keycode to macro_info index
 #define M_INDEX(kc) kc - (MACRO_RANGE_START + 1)
@@ -1,5 +1,4 @@
 CAPS_WORD_ENABLE = yes
-DEFERRED_EXEC_ENABLE = yes
 DYNAMIC_MACRO_ENABLE = yes
 MOUSEKEY_ENABLE = yes
 TAP_DANCE_ENABLE = yes
@@ -10,3 +9,13 @@ SRC += features/special_tap_dance.c
 SRC += features/dynamic_macro_status.c
 SRC += features/mouse_jiggler.c
 SRC += features/select_word.c
+SRC += features/macro_executor.c
+SRC += features/adaptive_tapping_term.c
+SRC += features/histogram.c
+SRC += features/task_scheduler.c
+SRC += features/scan_profiler.c
+SRC += features/key_latency.c
+SRC += features/particles.c
+SRC += features/life.c
+SRC += features/wpm_history.c
+SRC += features/notice_queue.c
@@ -1,56 +1,296 @@
 /* settings.c
  *
- * Manages user settings including OLED brightness, tap delays, and their storage in EEPROM.
+ * Manages user settings including OLED brightness, tap delays, learned tapping terms, and their storage in EEPROM.
  * Supports loading and saving settings to ensure custom configurations persist across resets.
  *
+ * Records are CRC checked and written round robin over SETTINGS_SLOTS slots, see settings.h. Settings saved by
+ * older firmware in the 32-bit user_config are migrated the first time no valid record is found.
+ *
+ * Changes are saved automatically once nothing has changed for SETTINGS_SAVE_DELAY, or when the host suspends.
+ * Saves that would write the same bytes as the current record are skipped and counted instead.
+ *
+ * Requires features/task_scheduler.c, with sched_run called from housekeeping_task_user.
+ *
  * Author: Ryan Turner
  */
 
 #include <settings.h>
+#include <stddef.h>
+#include "features/task_scheduler.h"
+
+// The single 32-bit word that settings were kept in before SETTINGS_VERSION 1, only read to migrate
+typedef union {
+	uint32_t raw;
+	struct {
+		uint16_t oled_state      : 4;
+		uint16_t oled_bri_div10  : 6;
+		uint16_t delay_base_div5 : 6;
+		uint16_t delay_ctrl_div5 : 6;
+		uint16_t delay_bksp_div5 : 6;
+		bool 	 oled_show_info  : 1;
+	};
+} legacy_config_t;
+
+#define SETTINGS_DATA_MAX (SETTINGS_SLOT_SIZE - sizeof(settings_header_t))
+
+#ifndef SETTINGS_SAVE_DELAY
+#define SETTINGS_SAVE_DELAY 3000 // Quiet time after the last change before it is written, in ms
+#endif
+
+// Slot and sequence number of the record that was loaded or saved last
+static uint8_t  current_slot = SETTINGS_SLOTS - 1;
+static uint16_t current_seq = 0;
+
+// Copy of what the current record holds, so saves that would not change anything can be skipped
+static settings_t stored;
+static bool       stored_valid = false;
+
+static bool dirty = false;
+static settings_save_stats_t save_stats = {0};
+
+static uint16_t crc16(uint16_t crc, const uint8_t *data, uint8_t len) {
+	while (len--) {
+		crc ^= (uint16_t)*data++ << 8;
+		for (uint8_t i = 0; i < 8; i++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+static uint16_t record_crc(const settings_header_t *header, const void *data) {
+	return crc16(crc16(0xFFFF, (const uint8_t *)header, offsetof(settings_header_t, crc)), data, header->size);
+}
+
+static uint8_t *slot_address(uint8_t slot) {
+	return (uint8_t *)EECONFIG_USER_DATABLOCK + (slot * SETTINGS_SLOT_SIZE);
+}
+
+static bool read_slot(uint8_t slot, settings_header_t *header, uint8_t *data) {
+	eeprom_read_block(header, slot_address(slot), sizeof(settings_header_t));
+	
+	if (!header->version || !header->size || (header->size > SETTINGS_DATA_MAX)) {
+		return false;
+	}
+	eeprom_read_block(data, slot_address(slot) + sizeof(settings_header_t), header->size);
+	
+	return header->crc == record_crc(header, data);
+}
+
+// Finds the newest valid record, comparing sequence numbers so that they can wrap around
+static bool read_latest(settings_header_t *latest, uint8_t *latest_data) {
+	settings_header_t header;
+	uint8_t data[SETTINGS_DATA_MAX];
+	bool found = false;
+	
+	for (uint8_t slot = 0; slot < SETTINGS_SLOTS; slot++) {
+		if (read_slot(slot, &header, data) && (!found || ((int16_t)(header.seq - latest->seq) > 0))) {
+			*latest = header;
+			memcpy(latest_data, data, header.size);
+			current_slot = slot;
+			current_seq = header.seq;
+			found = true;
+		}
+	}
+	return found;
+}
+
+static void default_settings(settings_t *settings) {
+	memset(settings, 0, sizeof(settings_t));
+	
+	settings->oled_show_info = true;
+	settings->oled_bri = OLED_BRIGHTNESS;
+	
+	settings->delay_base = TAP_DELAY_BASE;
+	settings->delay_ctrl = TAP_DELAY_CTRL;
+	settings->delay_bksp = TAP_DELAY_BKSP;
+	
+	settings->adaptive_enabled = true;
+}
+
+// Puts back the default of any setting outside the range its adjustment keys allow
+static void validate_settings(settings_t *settings) {
+	settings_t defaults;
+	default_settings(&defaults);
+	
+	if (settings->oled_bri > OLED_BRI_MAX) {
+		settings->oled_bri = defaults.oled_bri;
+	}
+	if ((settings->delay_base < DELAY_BASE_MIN) || (settings->delay_base > DELAY_MAX)) {
+		settings->delay_base = defaults.delay_base;
+	}
+	if ((settings->delay_ctrl < DELAY_MIN) || (settings->delay_ctrl > DELAY_MAX)) {
+		settings->delay_ctrl = defaults.delay_ctrl;
+	}
+	if ((settings->delay_bksp < DELAY_MIN) || (settings->delay_bksp > DELAY_MAX)) {
+		settings->delay_bksp = defaults.delay_bksp;
+	}
+	
+	// A term that could not have been learned is dropped and learned again
+	for (uint8_t i = 0; i < ADAPTIVE_TERM_KEYS; i++) {
+		if (settings->adaptive_term[i] > DELAY_MAX) {
+			settings->adaptive_term[i] = 0;
+		}
+	}
+}
+
+/* Version 0 kept most settings divided by 5 or 10 in user_config. It may never have been written, in which case it
+ * reads as erased EEPROM and the defaults are kept. Learned terms are not migrated and are learned again.
+ */
+static void migrate_legacy(settings_t *settings) {
+	legacy_config_t config = { .raw = eeconfig_read_user() };
+	
+	if (config.raw == UINT32_MAX) {
+		return;
+	}
+	
+	settings->oled_state = config.oled_state;
+	settings->oled_show_info = config.oled_show_info;
+	settings->oled_bri = config.oled_bri_div10 * 10;
+	
+	settings->delay_base = config.delay_base_div5 * 5;
+	settings->delay_ctrl = config.delay_ctrl_div5 * 5;
+	settings->delay_bksp = config.delay_bksp_div5 * 5;
+}
+
+static void apply_settings(const settings_t *settings) {
+	oled_state = settings->oled_state;
+	oled_show_info = settings->oled_show_info;
+	oled_bri = settings->oled_bri;
+	
+	delay_base = settings->delay_base;
+	delay_ctrl = settings->delay_ctrl;
+	delay_bksp = settings->delay_bksp;
+	
+	adaptive_term_enabled = settings->adaptive_enabled;
+	for (uint8_t i = 0; i < ADAPTIVE_TERM_KEYS; i++) {
+		adaptive_term_set(i, settings->adaptive_term[i]);
+	}
+	
+	oled_set_brightness (oled_bri);
+}
+
+static void collect_settings(settings_t *settings) {
+	memset(settings, 0, sizeof(settings_t));
+	
+	settings->oled_state = oled_state;
+	settings->oled_show_info = oled_show_info;
+	settings->oled_bri = oled_bri;
+	
+	settings->delay_base = delay_base;
+	settings->delay_ctrl = delay_ctrl;
+	settings->delay_bksp = delay_bksp;
+	
+	settings->adaptive_enabled = adaptive_term_enabled;
+	for (uint8_t i = 0; i < ADAPTIVE_TERM_KEYS; i++) {
+		settings->adaptive_term[i] = adaptive_term_learned(i);
+	}
+}
 
 // Runs if EEPROM has been reset
 void eeconfig_init_user(void) {
-	user_config.raw = 0;
+	settings_header_t empty = {0};
+	settings_t settings;
 	
-	oled_state = 0;
-	oled_show_info = true;
-	oled_bri = OLED_BRIGHTNESS;
+	// Clear every slot so that no record from before the reset can outrank the defaults
+	for (uint8_t slot = 0; slot < SETTINGS_SLOTS; slot++) {
+		eeprom_update_block(&empty, slot_address(slot), sizeof(empty));
+	}
+	current_slot = SETTINGS_SLOTS - 1;
+	current_seq = 0;
+	stored_valid = false;
 	
-	delay_base = TAP_DELAY_BASE;
-	delay_ctrl = TAP_DELAY_CTRL;
-	delay_bksp = TAP_DELAY_BKSP;
+	adaptive_term_reset();
+	default_settings(&settings);
+	apply_settings(&settings);
 
 	save_settings();
 }
 
-void keyboard_post_init_user(void) {
-	load_settings();
-}
-
 void load_settings(void) {
-	user_config.raw = eeconfig_read_user();
+	dirty = false;
 	
-	delay_base = user_config.delay_base_div5 * 5;
-	delay_ctrl = user_config.delay_ctrl_div5 * 5;
-	delay_bksp = user_config.delay_bksp_div5 * 5;
+	settings_header_t header;
+	uint8_t data[SETTINGS_DATA_MAX];
+	settings_t settings;
 	
-	oled_state = user_config.oled_state;
-	oled_show_info = user_config.oled_show_info;
-	oled_bri = user_config.oled_bri_div10 * 10;
+	default_settings(&settings);
 	
-	oled_set_brightness (oled_bri);
+	if (read_latest(&header, data)) {
+		// Records written by older versions are a prefix of settings_t, fields added since keep their defaults
+		memcpy(&settings, data, (header.size < sizeof(settings_t)) ? header.size : sizeof(settings_t));
+		validate_settings(&settings);
+		apply_settings(&settings);
+		
+		stored = settings;
+		stored_valid = (header.version == SETTINGS_VERSION) && (header.size == sizeof(settings_t));
+	} else {
+		migrate_legacy(&settings);
+		validate_settings(&settings);
+		apply_settings(&settings);
+		save_settings();
+	}
 }
 
+// Writes the next slot in the ring, with the header written last so an interrupted save is never valid
 void save_settings(void) {
-	user_config.delay_base_div5 = delay_base / 5;
-	user_config.delay_ctrl_div5 = delay_ctrl / 5;
-	user_config.delay_bksp_div5 = delay_bksp / 5;
+	settings_t settings;
+	collect_settings(&settings);
+	dirty = false;
+	
+	if (stored_valid && !memcmp(&settings, &stored, sizeof(settings_t))) {
+		save_stats.avoided++;
+		return;
+	}
 	
-	user_config.oled_state = oled_state;
-	user_config.oled_show_info = oled_show_info;
-	user_config.oled_bri_div10 = oled_bri / 10;
+	settings_header_t header = {
+		.seq     = current_seq + 1,
+		.version = SETTINGS_VERSION,
+		.size    = sizeof(settings_t),
+	};
+	header.crc = record_crc(&header, &settings);
 	
-	eeconfig_update_user(user_config.raw);
+	uint8_t slot = (current_slot + 1) % SETTINGS_SLOTS;
+	
+	eeprom_update_block(&settings, slot_address(slot) + sizeof(settings_header_t), sizeof(settings));
+	eeprom_update_block(&header, slot_address(slot), sizeof(header));
+	
+	current_slot = slot;
+	current_seq = header.seq;
+	stored = settings;
+	stored_valid = true;
+	save_stats.writes++;
+}
+
+static uint32_t save_task(void) {
+	if (dirty) {
+		save_settings();
+	}
+	return 0;
+}
+
+static sched_task_t autosave = SCHED_TASK("Save", SCHED_BACKGROUND, save_task);
+
+// Every change pushes the save back, so a burst of adjustments is written once after SETTINGS_SAVE_DELAY of quiet
+void settings_mark_dirty(void) {
+	dirty = true;
+	sched_start(&autosave, SETTINGS_SAVE_DELAY);
+}
+
+// Writes any pending change now instead of waiting for the quiet period
+void settings_flush(void) {
+	sched_stop(&autosave);
+	if (dirty) {
+		save_settings();
+	}
+}
+
+const settings_save_stats_t *settings_save_stats(void) {
+	return &save_stats;
+}
+
+void suspend_power_down_user(void) {
+	settings_flush();
 }
 
 // Helper function to adjust a setting within specified boundaries
@@ -60,4 +300,5 @@ void adjust_setting(uint16_t *setting, int16_t delta, uint16_t min, uint16_t max
 	} else {
 		*setting = (*setting >= (min - delta)) ? *setting + delta : min;
 	}
+	settings_mark_dirty();
 }
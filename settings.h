@@ -4,28 +4,53 @@
  * Includes definitions for settings like OLED brightness and tap delays, and prototypes for functions to manipulate these settings.
  *
  * Sections:
- * - User Configuration Structure: Defines a union for easy access to individual settings stored in EEPROM.
- * - Settings Prototypes: Declarations for functions related to settings initialization, loading, saving, and adjustment.
+ * - Settings Record: The versioned settings and the header that is stored with them in each slot of the ring.
+ * - Settings Prototypes: Declarations for functions related to settings initialization, loading, saving, auto-saving
+ *   and adjustment.
  */
 #pragma once
 
 #include "quantum.h"
+#include "features/adaptive_tapping_term.h"
 
-// For some reason the last few bits of user_config_t don't work so I leave 4 unused.
-// Variables may be stored after dividing by 5 or 10 so that they fit in only 6 bits
-typedef union {
-	uint32_t raw;
-	struct {
-		uint16_t oled_state      : 4;
-		uint16_t oled_bri_div10  : 6;
-		uint16_t delay_base_div5 : 6;
-		uint16_t delay_ctrl_div5 : 6;
-		uint16_t delay_bksp_div5 : 6;
-		bool 	 oled_show_info  : 1;
-	};
-} user_config_t;
-
-user_config_t user_config;
+/* Settings are stored as versioned records in a ring of slots across the user datablock, which needs
+ * EECONFIG_USER_DATA_SIZE from config.h. Each save goes to the next slot so writes are spread over the whole
+ * block, and loading takes the valid record with the highest sequence number.
+ *
+ * Every value is stored at full precision. Only add fields to the end of settings_t and bump SETTINGS_VERSION, older
+ * records are then loaded as a prefix and the new fields keep their defaults.
+ */
+#define SETTINGS_VERSION 1
+
+typedef struct {
+	uint16_t oled_state;
+	uint16_t oled_bri;
+	uint16_t delay_base;
+	uint16_t delay_ctrl;
+	uint16_t delay_bksp;
+	uint16_t adaptive_term[ADAPTIVE_TERM_KEYS];
+	bool     oled_show_info;
+	bool     adaptive_enabled;
+} settings_t;
+
+typedef struct {
+	uint16_t seq;     // Counts up with every save, wrapping around
+	uint8_t  version; // SETTINGS_VERSION when written, 0 is the old 32-bit user_config
+	uint8_t  size;    // sizeof(settings_t) when written
+	uint16_t crc;     // CRC-16/CCITT of the fields above and the settings that follow
+} settings_header_t;
+
+#define SETTINGS_SLOT_SIZE 64
+#define SETTINGS_SLOTS (EECONFIG_USER_DATA_SIZE / SETTINGS_SLOT_SIZE)
+
+_Static_assert(sizeof(settings_header_t) + sizeof(settings_t) <= SETTINGS_SLOT_SIZE, "settings_t does not fit in SETTINGS_SLOT_SIZE");
+_Static_assert(SETTINGS_SLOTS >= 2, "EECONFIG_USER_DATA_SIZE needs room for at least two settings slots");
+
+// Ranges the adjustment keys keep each setting in, loaded settings outside them are put back to their defaults
+#define OLED_BRI_MAX   250
+#define DELAY_BASE_MIN 100 // Zeroing delay_base can lock you out of LAYER_CONFIG
+#define DELAY_MIN      10
+#define DELAY_MAX      320
 
 // OLED state and brightness
 bool oled_show_info;
@@ -38,9 +63,17 @@ uint16_t delay_ctrl;
 uint16_t delay_bksp;
 
 void eeconfig_init_user(void);
-void keyboard_post_init_user(void);
+
+typedef struct {
+	uint16_t writes;  // Records written to EEPROM
+	uint16_t avoided; // Saves skipped because nothing had changed
+} settings_save_stats_t;
 
 void load_settings(void);
 void save_settings(void);
 
+void settings_mark_dirty(void);
+void settings_flush(void);
+const settings_save_stats_t *settings_save_stats(void);
+
 void adjust_setting(uint16_t *setting, int16_t delta, uint16_t min, uint16_t max);
@@ -0,0 +1,252 @@
+/* sim.c
+ *
+ * Replays press and release timelines through the tap dance features on a host. The clock counts in µs and the
+ * keyboard is scanned every SIM_SCAN_US, with QMK's millisecond timers read from the same clock.
+ *
+ * Tap dance processing follows quantum/process_keycode/process_tap_dance.c from QMK 0.22. A press of another key
+ * interrupts the waiting dance, each press of a dance restarts its tapping term, the finished callback runs once the
+ * term runs out or the dance is interrupted, and reset runs as soon as the dance is finished and its key is up. Only
+ * one dance waits on the term at a time, as in QMK, while any number can be held.
+ *
+ * Author: Ryan Turner
+ */
+
+#include "sim.h"
+#include <stdarg.h>
+
+#define SIM_HELD_KEYS 16
+
+static uint32_t now = 0; // In µs
+
+static char     log_buffer[SIM_LOG_LEN];
+static uint16_t log_len = 0;
+static bool     logging = true;
+
+static uint16_t held[SIM_HELD_KEYS];
+static uint32_t layers = 0;
+static bool     unbalanced = false; // A key was unregistered without being registered, or too many were held
+
+// Keycode of the dance waiting on its tapping term, and when it was last pressed
+static uint16_t active_td = 0;
+static uint16_t last_tap_time = 0;
+
+// ==========
+// = Timers =
+// ==========
+uint16_t timer_read(void) {
+	return now / 1000;
+}
+
+uint32_t timer_read32(void) {
+	return now / 1000;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+	return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+	return TIMER_DIFF_32(timer_read32(), last);
+}
+
+// =======
+// = Log =
+// =======
+static void sim_emit(const char *format, ...) {
+	if (!logging || (log_len >= SIM_LOG_LEN - 1)) {
+		return;
+	}
+
+	va_list args;
+	va_start(args, format);
+	if (log_len) {
+		log_buffer[log_len++] = ' ';
+	}
+	int written = vsnprintf(log_buffer + log_len, SIM_LOG_LEN - log_len, format, args);
+	va_end(args);
+
+	log_len = (log_len + written < SIM_LOG_LEN) ? log_len + written : SIM_LOG_LEN - 1;
+}
+
+const char *sim_log(void) {
+	return log_buffer;
+}
+
+void sim_logging(bool enabled) {
+	logging = enabled;
+}
+
+// =================
+// = Keys & Layers =
+// =================
+void register_code16(uint16_t keycode) {
+	for (uint8_t i = 0; i < SIM_HELD_KEYS; i++) {
+		if (!held[i]) {
+			held[i] = keycode;
+			sim_emit("+%s@%u", sim_key_name(keycode), timer_read());
+			return;
+		}
+	}
+	unbalanced = true;
+}
+
+void unregister_code16(uint16_t keycode) {
+	for (uint8_t i = 0; i < SIM_HELD_KEYS; i++) {
+		if (held[i] == keycode) {
+			held[i] = 0;
+			sim_emit("-%s@%u", sim_key_name(keycode), timer_read());
+			return;
+		}
+	}
+	unbalanced = true;
+}
+
+void tap_code16(uint16_t keycode) {
+	sim_emit("%s@%u", sim_key_name(keycode), timer_read());
+}
+
+void layer_on(uint8_t layer) {
+	layers |= 1UL << layer;
+	sim_emit("L%u+@%u", layer, timer_read());
+}
+
+void layer_off(uint8_t layer) {
+	layers &= ~(1UL << layer);
+	sim_emit("L%u-@%u", layer, timer_read());
+}
+
+void layer_invert(uint8_t layer) {
+	layers ^= 1UL << layer;
+	sim_emit("L%u^@%u", layer, timer_read());
+}
+
+// =============
+// = Tap Dance =
+// =============
+// Mirrors process_tap_dance.c, each step below is named after the QMK function it stands in for
+static void user_fn(tap_dance_action_t *action, tap_dance_user_fn_t fn) {
+	if (fn) {
+		fn(&action->state, action->user_data);
+	}
+}
+
+static void reset_tap_dance(tap_dance_action_t *action) {
+	user_fn(action, action->fn.on_reset);
+	action->state = (tap_dance_state_t){0};
+}
+
+static void on_dance_finished(tap_dance_action_t *action) {
+	if (!action->state.finished) {
+		action->state.finished = true;
+		user_fn(action, action->fn.on_dance_finished);
+	}
+	active_td = 0;
+
+	// There will be no release to reset on
+	if (!action->state.pressed) {
+		reset_tap_dance(action);
+	}
+}
+
+static void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
+	if (!record->event.pressed || !active_td || (keycode == active_td)) {
+		return;
+	}
+
+	tap_dance_action_t *action = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(active_td)];
+
+	action->state.interrupted = true;
+	action->state.interrupting_keycode = keycode;
+	on_dance_finished(action);
+}
+
+static void process_tap_dance(uint16_t keycode, keyrecord_t *record) {
+	tap_dance_action_t *action = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(keycode)];
+
+	action->state.pressed = record->event.pressed;
+	if (record->event.pressed) {
+		last_tap_time = timer_read();
+		action->state.count++;
+		user_fn(action, action->fn.on_each_tap);
+		active_td = action->state.finished ? 0 : keycode;
+	} else {
+		user_fn(action, action->fn.on_each_release);
+		if (action->state.finished) {
+			reset_tap_dance(action);
+			if (active_td == keycode) {
+				active_td = 0;
+			}
+		}
+	}
+}
+
+static void tap_dance_task(void) {
+	if (!active_td || (timer_elapsed(last_tap_time) <= get_tapping_term(active_td, &(keyrecord_t){0}))) {
+		return;
+	}
+
+	tap_dance_action_t *action = &tap_dance_actions[QK_TAP_DANCE_GET_INDEX(active_td)];
+
+	if (!action->state.interrupted) {
+		on_dance_finished(action);
+	}
+}
+
+// ============
+// = Timeline =
+// ============
+static void sim_event(const sim_event_t *event) {
+	keyrecord_t record = {
+		.event = {
+			.key     = {.col = event->keycode & 0x0F, .row = (event->keycode >> 4) & 0x07},
+			.pressed = event->pressed,
+			.time    = timer_read(),
+		},
+	};
+
+	preprocess_tap_dance(event->keycode, &record);
+	if (!process_record_user(event->keycode, &record)) {
+		return;
+	}
+
+	if (IS_QK_TAP_DANCE(event->keycode)) {
+		process_tap_dance(event->keycode, &record);
+	} else if (event->pressed) {
+		register_code16(event->keycode);
+	} else {
+		unregister_code16(event->keycode);
+	}
+}
+
+// Dances keep their per instance state between timelines, a timeline that leaves one mid dance shows up in sim_idle
+void sim_reset(void) {
+	now = 0;
+	log_len = 0;
+	log_buffer[0] = '\0';
+	memset(held, 0, sizeof(held));
+	layers = 0;
+	unbalanced = false;
+	active_td = 0;
+	last_tap_time = 0;
+}
+
+// Events must be in time order, each is seen by the first scan at or after its time
+void sim_run(const sim_event_t *events, uint16_t count, uint32_t end) {
+	uint16_t next = 0;
+
+	for (; now <= end; now += SIM_SCAN_US) {
+		while ((next < count) && (events[next].time <= now)) {
+			sim_event(&events[next++]);
+		}
+		tap_dance_task();
+	}
+}
+
+bool sim_idle(void) {
+	for (uint8_t i = 0; i < SIM_HELD_KEYS; i++) {
+		if (held[i]) {
+			return false;
+		}
+	}
+	return !layers && !active_td && !unbalanced;
+}
@@ -0,0 +1,43 @@
+/* sim.h
+ *
+ * Header file for the host tap dance simulator.
+ * Declares press and release timelines, the functions that replay them through a model of QMK's tap dance processing
+ * and the log of keycodes and layer changes they produce.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifndef SIM_SCAN_US
+#define SIM_SCAN_US 250 // Time between simulated matrix scans, in µs
+#endif
+
+#define SIM_LOG_LEN 512
+
+typedef struct {
+	uint32_t time;    // From the start of the timeline, in µs
+	uint16_t keycode;
+	bool     pressed;
+} sim_event_t;
+
+/* Everything the dances send is logged with the millisecond it happened at, separated by spaces.
+ *   +A@10   register_code16(A)     -A@10  unregister_code16(A)     A@10  tap_code16(A)
+ *   L2+@10  layer_on(2)            L2-@10 layer_off(2)             L2^@10 layer_invert(2)
+ * Keys that are not tap dances are logged as registered and unregistered when they are pressed and released.
+ */
+void sim_reset(void);
+void sim_run(const sim_event_t *events, uint16_t count, uint32_t end);
+const char *sim_log(void);
+void sim_logging(bool enabled); // Benchmarks turn the log off so that formatting it is not timed
+
+// True when no key is registered, no layer is on and no dance is waiting, which every timeline should end with
+bool sim_idle(void);
+
+// Provided by the test, called for every event before the dances see it like process_record_user in a keymap
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
+
+// Provided by the test, names keycodes in the log
+const char *sim_key_name(uint16_t keycode);
@@ -0,0 +1,111 @@
+/* quantum.h
+ *
+ * Stand in for QMK's quantum.h when building the tap dance features on a host.
+ * Declares only the part of QMK that special_tap_dance.c and adaptive_tapping_term.c use, with the same names and
+ * layouts as QMK so the feature files build unchanged. test/sim.c implements it.
+ *
+ * Author: Ryan Turner
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define uprintf(...) printf(__VA_ARGS__)
+
+// ==========
+// = Timers =
+// ==========
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+#define TIMER_DIFF_32(a, b) ((uint32_t)((a) - (b)))
+#define timer_expired32(current, future) ((uint32_t)((current) - (future)) < 0x80000000)
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+
+// ============
+// = Keycodes =
+// ============
+#define KC_A    0x04
+#define KC_B    0x05
+#define KC_C    0x06
+#define KC_D    0x07
+#define KC_E    0x08
+#define KC_ENT  0x28
+#define KC_ESC  0x29
+#define KC_BSPC 0x2A
+#define KC_CAPS 0x39
+#define KC_F11  0x44
+#define KC_LCTL 0xE0
+#define KC_LSFT 0xE1
+#define KC_LALT 0xE2
+#define KC_LGUI 0xE3
+
+#define QK_LCTL 0x0100
+#define LCTL(kc) (QK_LCTL | (kc))
+
+#define QK_TAP_DANCE 0x5700
+#define QK_TAP_DANCE_MAX 0x57FF
+#define QK_TAP_DANCE_GET_INDEX(kc) ((kc) & 0xFF)
+#define IS_QK_TAP_DANCE(kc) (((kc) >= QK_TAP_DANCE) && ((kc) <= QK_TAP_DANCE_MAX))
+#define TD(n) (QK_TAP_DANCE | ((n) & 0xFF))
+
+typedef struct {
+	uint8_t col;
+	uint8_t row;
+} keypos_t;
+
+typedef struct {
+	keypos_t key;
+	bool     pressed;
+	uint16_t time;
+} keyevent_t;
+
+typedef struct {
+	keyevent_t event;
+} keyrecord_t;
+
+void register_code16(uint16_t keycode);
+void unregister_code16(uint16_t keycode);
+void tap_code16(uint16_t keycode);
+
+// ==========
+// = Layers =
+// ==========
+void layer_on(uint8_t layer);
+void layer_off(uint8_t layer);
+void layer_invert(uint8_t layer);
+
+// =============
+// = Tap Dance =
+// =============
+typedef struct {
+	uint16_t interrupting_keycode;
+	uint8_t  count;
+	bool     pressed : 1;
+	bool     finished : 1;
+	bool     interrupted : 1;
+} tap_dance_state_t;
+
+typedef void (*tap_dance_user_fn_t)(tap_dance_state_t *state, void *user_data);
+
+typedef struct {
+	tap_dance_state_t state;
+	struct {
+		tap_dance_user_fn_t on_each_tap;
+		tap_dance_user_fn_t on_dance_finished;
+		tap_dance_user_fn_t on_reset;
+		tap_dance_user_fn_t on_each_release;
+	} fn;
+	void *user_data;
+} tap_dance_action_t;
+
+extern tap_dance_action_t tap_dance_actions[];
+
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,261 @@
+/* tap_dance_test.c
+ *
+ * Host tests for special_tap_dance.c and adaptive_tapping_term.c. Each case replays a press and release timeline
+ * through sim.c and checks the keycodes and layer changes the dances sent and when they sent them. Dances are set up
+ * the same way as the keymap's, with a tap hold, a quad whose double hold holds a config layer like CAPS_IME, a tri
+ * and a single action quad that commit early, and a quad that toggles layers on reset.
+ *
+ * Run with make -C test, or make -C test bench to replay random timelines in bulk. The benchmark times the decision
+ * paths, prints the decision statistics and checks that every timeline leaves each dance reset with nothing held.
+ *
+ * Author: Ryan Turner
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "sim.h"
+#include "special_tap_dance.h"
+#include "adaptive_tapping_term.h"
+#include "key_latency.h"
+
+#define MS(ms) ((uint32_t)(ms) * 1000)
+#define TERM 200
+
+enum {
+	TD_TH,     // Tap hold, like BKSP_BSL
+	TD_QUAD,   // Double hold holds layer 5, like CAPS_IME holding LAYER_CONFIG
+	TD_TRI,    // Double tap and double hold are the same, so it commits on the second press
+	TD_SOLO,   // No double action, so a single tap commits on release
+	TD_TOGGLE, // Toggles layers on reset, like TD_F13_L
+	TD_COUNT
+};
+
+tap_dance_action_t tap_dance_actions[] = {
+	[TD_TH]     = ACTION_TAP_DANCE_TAP_HOLD(LCTL(KC_BSPC), KC_B),
+	[TD_QUAD]   = ACTION_TAP_DANCE_QUAD(KC_C, 1, TDM_LH, KC_CAPS, TDM_KC, 5, TDM_LH),
+	[TD_TRI]    = ACTION_TAP_DANCE_TRI (KC_D, KC_LCTL, TDM_KC, KC_E, TDM_KC),
+	[TD_SOLO]   = ACTION_TAP_DANCE_QUAD_FULL(KC_A, TDM_KC, KC_LSFT, TDM_KC, 0, TDM_NO, 0, TDM_NO),
+	[TD_TOGGLE] = ACTION_TAP_DANCE_QUAD_FULL(3, TDM_LT, 3, TDM_LH, 4, TDM_LT, 4, TDM_LH),
+};
+
+// ==========
+// = Keymap =
+// ==========
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+	process_adaptive_term(keycode, record);
+	process_tap_dance_stats(keycode, record, TD(TD_TH));
+	return true;
+}
+
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+	return adaptive_term_get(keycode, TERM);
+}
+
+// Latency is measured against keyboard reports, which the simulator does not send
+void key_latency_arm(key_path_t path, uint16_t start) {}
+
+// The keymap saves its settings on each change, here they are only counted
+static uint32_t term_changes = 0;
+
+void adaptive_term_changed_user(uint8_t index) {
+	term_changes++;
+}
+
+const char *sim_key_name(uint16_t keycode) {
+	static char name[8];
+
+	switch (keycode) {
+		case KC_A:    return "A";
+		case KC_B:    return "B";
+		case KC_C:    return "C";
+		case KC_D:    return "D";
+		case KC_E:    return "E";
+		case KC_CAPS: return "CAPS";
+		case KC_LCTL: return "LCTL";
+		case KC_LSFT: return "LSFT";
+		case LCTL(KC_BSPC): return "C(BSPC)";
+		default:
+			snprintf(name, sizeof(name), "0x%04X", keycode);
+			return name;
+	}
+}
+
+// =========
+// = Cases =
+// =========
+#define DOWN(ms, kc) {MS(ms), kc, true}
+#define UP(ms, kc)   {MS(ms), kc, false}
+
+typedef struct {
+	const char        *name;
+	uint16_t           learned[TD_COUNT]; // Terms loaded into adaptive_tapping_term before the timeline, 0 for none
+	const sim_event_t *events;
+	uint16_t           count;
+	const char        *expected;
+} sim_case_t;
+
+#define CASE(case_name, case_expected, ...) \
+	{ .name = case_name, .expected = case_expected, .events = (const sim_event_t[]){__VA_ARGS__}, \
+	  .count = sizeof((const sim_event_t[]){__VA_ARGS__}) / sizeof(sim_event_t) }
+
+#define LEARNED_CASE(case_name, quad_term, case_expected, ...) \
+	{ .name = case_name, .learned = {[TD_QUAD] = quad_term}, .expected = case_expected, \
+	  .events = (const sim_event_t[]){__VA_ARGS__}, .count = sizeof((const sim_event_t[]){__VA_ARGS__}) / sizeof(sim_event_t) }
+
+// A dance finishes on the first scan after its term has passed, which is 1 ms after the term with 1 ms timers
+static const sim_case_t cases[] = {
+	CASE("tap hold taps on release", "C(BSPC)@50",
+		DOWN(0, TD(TD_TH)), UP(50, TD(TD_TH))),
+	CASE("tap hold holds after the term", "+B@201 -B@300",
+		DOWN(0, TD(TD_TH)), UP(300, TD(TD_TH))),
+	CASE("tap hold double hold holds the tap", "C(BSPC)@50 +C(BSPC)@301 -C(BSPC)@500",
+		DOWN(0, TD(TD_TH)), UP(50, TD(TD_TH)), DOWN(100, TD(TD_TH)), UP(500, TD(TD_TH))),
+
+	CASE("quad single tap waits for the term", "C@201",
+		DOWN(0, TD(TD_QUAD)), UP(50, TD(TD_QUAD))),
+	CASE("quad single hold holds a layer", "L1+@201 L1-@400",
+		DOWN(0, TD(TD_QUAD)), UP(400, TD(TD_QUAD))),
+	CASE("quad double tap", "CAPS@301",
+		DOWN(0, TD(TD_QUAD)), UP(50, TD(TD_QUAD)), DOWN(100, TD(TD_QUAD)), UP(150, TD(TD_QUAD))),
+	CASE("quad double hold holds a layer", "L5+@301 L5-@500",
+		DOWN(0, TD(TD_QUAD)), UP(50, TD(TD_QUAD)), DOWN(100, TD(TD_QUAD)), UP(500, TD(TD_QUAD))),
+	CASE("quad interrupted by another key holds", "L1+@50 +A@50 -A@80 L1-@120",
+		DOWN(0, TD(TD_QUAD)), DOWN(50, KC_A), UP(80, KC_A), UP(120, TD(TD_QUAD))),
+	CASE("quad toggles layers on reset", "L3^@201 L3^@651",
+		DOWN(0, TD(TD_TOGGLE)), UP(50, TD(TD_TOGGLE)), DOWN(450, TD(TD_TOGGLE)), UP(500, TD(TD_TOGGLE))),
+	CASE("quad double tap toggles on reset", "L4^@301 L4^@851",
+		DOWN(0, TD(TD_TOGGLE)), UP(50, TD(TD_TOGGLE)), DOWN(100, TD(TD_TOGGLE)), UP(150, TD(TD_TOGGLE)),
+		DOWN(500, TD(TD_TOGGLE)), UP(550, TD(TD_TOGGLE)), DOWN(650, TD(TD_TOGGLE)), UP(700, TD(TD_TOGGLE))),
+
+	CASE("tri commits on the second press", "+E@100 -E@150",
+		DOWN(0, TD(TD_TRI)), UP(50, TD(TD_TRI)), DOWN(100, TD(TD_TRI)), UP(150, TD(TD_TRI))),
+	CASE("single action quad commits on release", "A@50",
+		DOWN(0, TD(TD_SOLO)), UP(50, TD(TD_SOLO))),
+	CASE("single action quad still holds", "+LSFT@201 -LSFT@300",
+		DOWN(0, TD(TD_SOLO)), UP(300, TD(TD_SOLO))),
+
+	CASE("overlapping dances keep their own state", "L1+@50 D@251 L1-@300",
+		DOWN(0, TD(TD_QUAD)), DOWN(50, TD(TD_TRI)), UP(80, TD(TD_TRI)), UP(300, TD(TD_QUAD))),
+	CASE("held tri and quad release in any order", "+LCTL@201 -LCTL@300 L1+@461 L1-@700",
+		DOWN(0, TD(TD_TRI)), DOWN(260, TD(TD_QUAD)), UP(300, TD(TD_TRI)), UP(700, TD(TD_QUAD))),
+
+	LEARNED_CASE("learned term decides a first hold", 80, "L1+@81 L1-@300",
+		DOWN(0, TD(TD_QUAD)), UP(300, TD(TD_QUAD))),
+	LEARNED_CASE("learned term keeps the double hold window", 80, "L5+@361 L5-@600",
+		DOWN(0, TD(TD_QUAD)), UP(60, TD(TD_QUAD)), DOWN(160, TD(TD_QUAD)), UP(600, TD(TD_QUAD))),
+	LEARNED_CASE("learned term keeps the double tap window", 80, "CAPS@361",
+		DOWN(0, TD(TD_QUAD)), UP(60, TD(TD_QUAD)), DOWN(160, TD(TD_QUAD)), UP(200, TD(TD_QUAD))),
+};
+
+static bool run_case(const sim_case_t *test) {
+	adaptive_term_reset();
+	for (uint8_t i = 0; i < TD_COUNT; i++) {
+		adaptive_term_set(i, test->learned[i]);
+	}
+
+	sim_reset();
+	sim_run(test->events, test->count, test->events[test->count - 1].time + MS(TERM * 2));
+
+	bool passed = !strcmp(sim_log(), test->expected) && sim_idle();
+
+	printf("%s %s\n", passed ? "ok  " : "FAIL", test->name);
+	if (!passed) {
+		printf("     expected: %s\n     got:      %s%s\n", test->expected, sim_log(), sim_idle() ? "" : " (not idle)");
+	}
+	return passed;
+}
+
+// =============
+// = Benchmark =
+// =============
+static uint32_t random_state = 0x12345678;
+
+static uint32_t random_range(uint32_t min, uint32_t max) {
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return min + (random_state % (max - min + 1));
+}
+
+// One to three presses of a random dance with random timing, sometimes interrupted by another key
+static uint16_t random_timeline(sim_event_t *events) {
+	static const uint8_t dances[] = {TD_TH, TD_QUAD, TD_TRI, TD_SOLO};
+	uint16_t keycode = TD(dances[random_range(0, sizeof(dances) - 1)]);
+	uint8_t  presses = random_range(1, 3);
+	uint32_t time = 0;
+	uint16_t count = 0;
+
+	for (uint8_t i = 0; i < presses; i++) {
+		uint32_t held = MS(random_range(20, 400));
+
+		events[count++] = (sim_event_t){time, keycode, true};
+		if (random_range(0, 3) == 0) {
+			uint32_t other = time + (held / 2);
+
+			events[count++] = (sim_event_t){other, KC_A, true};
+			events[count++] = (sim_event_t){other + MS(10), KC_A, false};
+			held += MS(10);
+		}
+		time += held;
+		events[count++] = (sim_event_t){time, keycode, false};
+		time += MS(random_range(20, 300));
+	}
+	return count;
+}
+
+static int bench(uint32_t timelines) {
+	sim_event_t events[12];
+	uint32_t total_events = 0;
+	uint32_t failures = 0;
+	double seconds = 0;
+
+	adaptive_term_reset();
+	sim_logging(false);
+
+	for (uint32_t i = 0; i < timelines; i++) {
+		uint16_t count = random_timeline(events);
+		struct timespec start, end;
+
+		sim_reset();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		sim_run(events, count, events[count - 1].time + MS(TERM * 2));
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		seconds += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+		total_events += count;
+
+		// Every dance has to be back at rest, with nothing left held and its per instance state cleared
+		bool reset = sim_idle();
+		for (uint8_t d = 0; d < TD_COUNT; d++) {
+			reset &= !tap_dance_actions[d].state.count;
+		}
+		if (!reset) {
+			failures++;
+		}
+	}
+
+	printf("%lu timelines, %lu events in %.3f s, %.0f ns per event including scans\n", (unsigned long)timelines,
+		(unsigned long)total_events, seconds, seconds * 1e9 / total_events);
+	printf("%lu timelines left a dance or key active\n", (unsigned long)failures);
+	printf("Learned terms: tap hold %u, quad %u, tri %u, single %u, changed %lu times\n", adaptive_term_learned(TD_TH),
+		adaptive_term_learned(TD_QUAD), adaptive_term_learned(TD_TRI), adaptive_term_learned(TD_SOLO),
+		(unsigned long)term_changes);
+	tap_dance_stats_dump();
+
+	return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+	if ((argc > 1) && !strcmp(argv[1], "--bench")) {
+		return bench((argc > 2) ? strtoul(argv[2], NULL, 10) : 20000);
+	}
+
+	uint16_t failed = 0;
+
+	for (uint16_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+		failed += !run_case(&cases[i]);
+	}
+	printf("%u of %u cases failed\n", failed, (unsigned)(sizeof(cases) / sizeof(cases[0])));
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}